@@ -20,6 +20,7 @@ public:
 	void     ToggleMouseCursorVisibility( void ) override { return; }
 	bool     IsMouseCursorVisible( void ) const override { return false; }
 	void     Update( void ) override { return; }
+	void     Sample( void ) override { return; }
 };
 
 }
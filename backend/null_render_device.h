@@ -24,6 +24,7 @@ public:
 	void RenderDisplayModel(const retro3d::DisplayModel&, const mmlMatrix<4,4>&, LightMode, RenderMode) override {}
 	void RenderSpritePlane(const retro3d::Model&, const mmlMatrix<4,4>&, LightMode, RenderMode) override {}
 	void RenderSpritePlane(const retro3d::Model&, const mmlMatrix<4,4>*, LightMode, RenderMode) override {}
+	void RenderSprites(const SpriteBatch&, RenderMode) override {}
 	void RenderLight(const retro3d::Light&) override {}
 	void RenderAABB(const retro3d::AABB&, const mmlMatrix<4,4>&, const mmlVector<3>&, bool) override {}
 	void RenderAABB(const retro3d::AABB&, const mmlMatrix<4,4>*, const mmlVector<3>&, bool) override {}
@@ -51,6 +52,7 @@ public:
 	float GetVerticalFieldOfView( void ) const override { return 0.0f; }
 	void  SetHorizontalFieldOfView(float) override {}
 	retro3d::Frustum GetViewFrustum( void ) const override { return retro3d::Frustum(); }
+	FrameStats GetFrameStats( void ) const override { return FrameStats{ 0, 0, 0, 0, 0, 0, 0, 0, 0 }; }
 
 	void Debug_RenderTriangle(const retro3d::Vertex&, const retro3d::Vertex&, const retro3d::Vertex&, const mmlMatrix<4,4>&, const mmlMatrix<4,4>&, const retro3d::Texture*, LightMode) override {};
 };
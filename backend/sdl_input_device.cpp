@@ -200,6 +200,17 @@ SDL_Scancode ToSDLKeycode(uint64_t code)
 }
 #endif
 
+uint64_t ToMouseCode(Uint8 button)
+{
+	switch (button) {
+	case SDL_BUTTON_LEFT:   return retro3d::Mouse::Left;
+	case SDL_BUTTON_RIGHT:  return retro3d::Mouse::Right;
+	case SDL_BUTTON_MIDDLE: return retro3d::Mouse::Mid;
+	default: break;
+	}
+	return retro3d::INPUT_COUNT;
+}
+
 void platform::SDLInputDevice::UpdateState(retro3d::InputDevice::Input &internal_state, float api_state, double delta_time)
 {
 	float prev_state = internal_state.activation;
@@ -212,6 +223,15 @@ void platform::SDLInputDevice::UpdateState(retro3d::InputDevice::Input &internal
 platform::SDLInputDevice::SDLInputDevice( void ) : retro3d::InputDevice(), m_last_update(0), m_mouse_correction_x(0), m_mouse_correction_y(0), m_mouse_locked(false), m_mouse_visible(true), m_user_quit(false)
 {
 	CreateStateTable(retro3d::INPUT_COUNT + 1);
+#ifdef RETRO3D_USE_SDL1
+	m_key_codes.resize(SDLK_LAST, retro3d::INPUT_COUNT);
+#elif defined(RETRO3D_USE_SDL2)
+	m_key_codes.resize(SDL_NUM_SCANCODES, retro3d::INPUT_COUNT);
+#endif
+	for (uint64_t i = retro3d::Keyboard::FIRST; i < retro3d::Keyboard::LAST; ++i) {
+		m_key_codes[ToSDLKeycode(i)] = i;
+	}
+	m_key_codes[0] = retro3d::INPUT_COUNT; // NOTE: Unknown keys.
 }
 
 platform::SDLInputDevice::~SDLInputDevice( void )
@@ -271,13 +291,59 @@ bool platform::SDLInputDevice::IsMouseCursorVisible( void ) const
 	return m_mouse_visible;
 }
 
+void platform::SDLInputDevice::PollEvents( void )
+{
+	// NOTE: SDL1 events carry no timestamp, so they are stamped when they are polled.
+	SDL_Event event;
+	while (SDL_PollEvent(&event) != 0) {
+#ifdef RETRO3D_USE_SDL1
+		const uint64_t time = GetProgramTimeMS();
+#elif defined(RETRO3D_USE_SDL2)
+		const uint64_t time = uint64_t(event.common.timestamp);
+#endif
+		switch (event.type) {
+		case SDL_QUIT:
+			m_user_quit = true;
+			break;
+
+		case SDL_KEYDOWN:
+		case SDL_KEYUP:
+		{
+#ifdef RETRO3D_USE_SDL1
+			const uint64_t key = uint64_t(event.key.keysym.sym);
+#elif defined(RETRO3D_USE_SDL2)
+			if (event.key.repeat != 0) { break; }
+			const uint64_t key = uint64_t(event.key.keysym.scancode);
+#endif
+			if (key < m_key_codes.size() && m_key_codes[key] != retro3d::INPUT_COUNT) {
+				PushEvent(m_key_codes[key], event.type == SDL_KEYDOWN ? 1.0f : 0.0f, time);
+			}
+			break;
+		}
+
+		case SDL_MOUSEBUTTONDOWN:
+		case SDL_MOUSEBUTTONUP:
+		{
+			const uint64_t button = ToMouseCode(event.button.button);
+			if (button != retro3d::INPUT_COUNT) {
+				PushEvent(button, event.type == SDL_MOUSEBUTTONDOWN ? 1.0f : 0.0f, time);
+			}
+			break;
+		}
+
+		default: break;
+		}
+	}
+}
+
 void platform::SDLInputDevice::Update( void )
 {
 	uint64_t time = GetProgramTimeMS();
 	uint64_t time_diff = time - m_last_update;
 	double delta_time = double(time_diff) / 1000.0;
 
-	SDL_PumpEvents();
+	BeginEvents();
+	PollEvents();
 #ifdef RETRO3D_USE_SDL1
 	Uint8 *keys = SDL_GetKeyState(nullptr);
 #elif defined(RETRO3D_USE_SDL2)
@@ -315,5 +381,26 @@ void platform::SDLInputDevice::Update( void )
 		m_state[retro3d::Mouse::MoveY].delta = -m_state[retro3d::Mouse::MoveY].delta;
 	}
 
+	ApplyEvents();
+
 	m_last_update = time;
 }
+
+void platform::SDLInputDevice::Sample( void )
+{
+	BeginSample();
+	PollEvents();
+	ApplySampledEvents();
+
+	// NOTE: A locked cursor is re-centered once per update, so its motion is only read by Update.
+	if (m_mouse_locked == false) {
+		int x, y;
+		SDL_GetMouseState(&x, &y);
+		retro3d::InputDevice::Input &move_x = m_state[retro3d::Mouse::MoveX];
+		retro3d::InputDevice::Input &move_y = m_state[retro3d::Mouse::MoveY];
+		move_x.delta += float(x) - move_x.activation;
+		move_y.delta += float(y) - move_y.activation;
+		move_x.activation = float(x);
+		move_y.activation = float(y);
+	}
+}
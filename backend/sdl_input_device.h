@@ -9,14 +9,16 @@ namespace platform
 class SDLInputDevice : public retro3d::InputDevice
 {
 private:
-	uint64_t m_last_update;
-	int32_t  m_mouse_correction_x, m_mouse_correction_y;
-	bool     m_mouse_locked;
-	bool     m_mouse_visible;
-	bool     m_user_quit;
+	std::vector<uint64_t> m_key_codes; // SDL key -> retro3d::Keyboard code, or INPUT_COUNT if the key is not mapped.
+	uint64_t              m_last_update;
+	int32_t               m_mouse_correction_x, m_mouse_correction_y;
+	bool                  m_mouse_locked;
+	bool                  m_mouse_visible;
+	bool                  m_user_quit;
 
 private:
 	void UpdateState(retro3d::InputDevice::Input &internal_state, float api_state, double delta_time);
+	void PollEvents( void );
 
 public:
 	SDLInputDevice( void );
@@ -33,6 +35,7 @@ public:
 	void     ToggleMouseCursorVisibility( void ) override;
 	bool     IsMouseCursorVisible( void ) const override;
 	void     Update( void ) override;
+	void     Sample( void ) override;
 };
 
 }
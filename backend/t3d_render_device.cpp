@@ -1,54 +1,202 @@
-#include <sstream>
-#include <iomanip>
+#include <charconv>
 #include "../common/MiniLib/MML/mmlMath.h"
 #include "../api/tiny3d/tiny_draw.h"
 #include "../retro3d.h"
 #include "../common/retro_transform.h"
 #include "t3d_render_device.h"
 
+mmlMatrix<4,4> *platform::T3DRenderDevice::AllocTransform( void )
+{
+	if (m_num_transforms >= m_transform_arena.GetSize()) {
+		return nullptr;
+	}
+	m_stats.bytes_submitted += uint32_t(sizeof(mmlMatrix<4,4>));
+	return &m_transform_arena[m_num_transforms++];
+}
+
+tiny3d::UInt platform::T3DRenderDevice::InternText(const char *str, tiny3d::UInt len, tiny3d::UInt &offset)
+{
+	// NOTE: Text that does not fit in the arena is truncated.
+	const tiny3d::UInt available = m_text_arena.GetSize() - m_text_arena_size;
+	if (len > available) {
+		++m_stats.jobs_dropped;
+		len = available;
+	}
+	offset = m_text_arena_size;
+	for (tiny3d::UInt i = 0; i < len; ++i) {
+		m_text_arena[m_text_arena_size + i] = str[i];
+	}
+	m_text_arena_size += len;
+	m_stats.text_bytes += uint32_t(len);
+	m_stats.bytes_submitted += uint32_t(len);
+	return len;
+}
+
+mmlMatrix<4,4> platform::T3DRenderDevice::GetWorldToObj(const platform::T3DRenderDevice::Render3DJob &job) const
+{
+	return job.world_to_obj != nullptr ? *job.world_to_obj : mmlInv(*job.obj_to_world);
+}
+
 platform::T3DRenderDevice::Render3DJob *platform::T3DRenderDevice::Add3DJob(platform::T3DRenderDevice::Render3DJob::Type type, const mmlMatrix<4,4> &obj_to_world, retro3d::RenderDevice::LightMode light_mode)
 {
+	// NOTE: Check the queue first so that a dropped job neither takes a transform nor is counted twice.
 	if (m_num_3d_items >= m_3d_queue.GetSize()) {
-		RenderText(retro_text_err("render overflow\n"));
+		++m_stats.jobs_dropped;
+		Add2DText(Render2DJob::Text, "render overflow\n", 16, tiny3d::Point{ 0,0 }, tiny3d::Color{ 255,0,0,tiny3d::Color::Solid });
 		return nullptr;
-	} else {
-		m_3d_queue[m_num_3d_items].type             = type;
-		m_3d_queue[m_num_3d_items].light_mode       = light_mode;
-		m_3d_queue[m_num_3d_items].obj_to_world     = obj_to_world;
-		m_3d_queue[m_num_3d_items].world_to_obj     = mmlInv(obj_to_world);
-		m_3d_queue[m_num_3d_items].obj_to_world_ptr = &m_3d_queue[m_num_3d_items].obj_to_world;
-		++m_num_3d_items;
 	}
-	return &m_3d_queue[m_num_3d_items - 1];
+	mmlMatrix<4,4> *transform = AllocTransform();
+	if (transform == nullptr) {
+		++m_stats.jobs_dropped;
+		return nullptr;
+	}
+	*transform = obj_to_world;
+	Render3DJob *job = Add3DJob(type, transform, light_mode);
+	if (job != nullptr && (light_mode == LightMode_Dynamic || type == Render3DJob::DisplayModel)) {
+		// NOTE: Only lighting and BSP traversal needs the inverse, so do not pay for it unless necessary.
+		mmlMatrix<4,4> *inv_transform = AllocTransform();
+		if (inv_transform != nullptr) {
+			*inv_transform = mmlInv(obj_to_world);
+			job->world_to_obj = inv_transform;
+		}
+	}
+	return job;
 }
 
 platform::T3DRenderDevice::Render3DJob *platform::T3DRenderDevice::Add3DJob(platform::T3DRenderDevice::Render3DJob::Type type, const mmlMatrix<4,4> *obj_to_world, retro3d::RenderDevice::LightMode light_mode)
 {
 	if (m_num_3d_items >= m_3d_queue.GetSize()) {
-		RenderText(retro_text_err("render overflow\n"));
+		++m_stats.jobs_dropped;
+		Add2DText(Render2DJob::Text, "render overflow\n", 16, tiny3d::Point{ 0,0 }, tiny3d::Color{ 255,0,0,tiny3d::Color::Solid });
 		return nullptr;
-	} else {
-		m_3d_queue[m_num_3d_items].type             = type;
-		m_3d_queue[m_num_3d_items].light_mode       = light_mode;
-		m_3d_queue[m_num_3d_items].obj_to_world_ptr = obj_to_world;
-		++m_num_3d_items;
 	}
-	return &m_3d_queue[m_num_3d_items - 1];
+	Render3DJob *job = &m_3d_queue[m_num_3d_items++];
+	job->type               = type;
+	job->light_mode         = light_mode;
+	job->render_mode        = RenderMode_Polygons;
+	job->obj_to_world       = obj_to_world;
+	job->world_to_obj       = nullptr;
+	job->world_axis_aligned = false;
+	job->face_camera        = false;
+	++m_stats.jobs_3d;
+	m_stats.bytes_submitted += uint32_t(sizeof(Render3DJob));
+	return job;
 }
 
 platform::T3DRenderDevice::Render2DJob *platform::T3DRenderDevice::Add2DJob(platform::T3DRenderDevice::Render2DJob::Type type, tiny3d::Point xy, tiny3d::Color color)
 {
 	if (m_num_2d_items < m_2d_queue.GetSize()) {
-		m_2d_queue[m_num_2d_items].type  = type;
-		m_2d_queue[m_num_2d_items].xy    = xy;
-		m_2d_queue[m_num_2d_items].color = color;
-		m_2d_queue[m_num_2d_items].scale = 1;
-		++m_num_2d_items;
-		return &m_2d_queue[m_num_2d_items - 1];
+		Render2DJob *job = &m_2d_queue[m_num_2d_items++];
+		job->type        = type;
+		job->xy          = xy;
+		job->color       = color;
+		job->scale       = 1;
+		job->text_offset = 0;
+		job->text_length = 0;
+		++m_stats.jobs_2d;
+		m_stats.bytes_submitted += uint32_t(sizeof(Render2DJob));
+		return job;
+	}
+	++m_stats.jobs_dropped;
+	return nullptr;
+}
+
+platform::T3DRenderDevice::Render2DJob *platform::T3DRenderDevice::Add2DText(platform::T3DRenderDevice::Render2DJob::Type type, const char *str, tiny3d::UInt len, tiny3d::Point xy, tiny3d::Color color)
+{
+	Render2DJob *job = Add2DJob(type, xy, color);
+	if (job != nullptr) {
+		job->text_length = InternText(str, len, job->text_offset);
+	}
+	return job;
+}
+
+platform::T3DRenderDevice::Render2DJob *platform::T3DRenderDevice::AddTextFree(const char *str, tiny3d::UInt len, tiny3d::Point xy, uint32_t scale, tiny3d::Color color)
+{
+	const tiny3d::Image *run = FindTextRun(str, len, scale, color);
+	if (run != nullptr) {
+		Render2DJob *job = Add2DJob(Render2DJob::TextRun, xy, color);
+		if (job != nullptr) {
+			job->text_run = run;
+			job->scale    = scale;
+			++m_stats.text_runs_blit;
+		}
+		return job;
+	}
+	Render2DJob *job = Add2DText(Render2DJob::TextFree, str, len, xy, color);
+	if (job != nullptr) {
+		job->scale = scale;
+	}
+	return job;
+}
+
+const tiny3d::Image *platform::T3DRenderDevice::FindTextRun(const char *str, tiny3d::UInt len, uint32_t scale, tiny3d::Color color)
+{
+	if (len == 0 || scale == 0) {
+		return nullptr;
+	}
+
+	// NOTE: FNV-1a over the text, scale and color.
+	uint64_t hash = 14695981039346656037ULL;
+	for (tiny3d::UInt i = 0; i < len; ++i) {
+		if (str[i] == '\n') { // NOTE: Multi-line text wraps and can not be pre-rasterized as a single run.
+			return nullptr;
+		}
+		hash = (hash ^ uint64_t(tiny3d::Byte(str[i]))) * 1099511628211ULL;
+	}
+	hash = (hash ^ uint64_t(scale)) * 1099511628211ULL;
+	hash = (hash ^ ((uint64_t(color.r) << 16) | (uint64_t(color.g) << 8) | uint64_t(color.b))) * 1099511628211ULL;
+
+	tiny3d::UInt lru = 0;
+	for (tiny3d::UInt i = 0; i < m_text_runs.GetSize(); ++i) {
+		TextRun &run = m_text_runs[i];
+		if (run.hash == hash && run.scale == scale && run.color.r == color.r && run.color.g == color.g && run.color.b == color.b && run.text.size() == len && run.text.compare(0, len, str, len) == 0) {
+			if (run.last_frame + 1 < m_frames_rendered) {
+				// NOTE: Not seen last frame, so treat the line as volatile again.
+				run.image.Destroy();
+			} else if (run.image.GetWidth() == 0) {
+				if (run.image.Create(tiny3d::UInt(len * TINY3D_CHAR_WIDTH * scale), tiny3d::UInt(TINY3D_CHAR_HEIGHT * scale)) == true) {
+					run.image.Fill(tiny3d::Color{ 0, 0, 0, tiny3d::Color::Transparent });
+					tiny3d::DrawChars(run.image, tiny3d::Point{ 0, 0 }, 0, str, len, color, scale);
+				}
+			}
+			run.last_frame = m_frames_rendered;
+			return run.image.GetWidth() > 0 ? &run.image : nullptr;
+		}
+		if (run.last_frame < m_text_runs[lru].last_frame) {
+			lru = i;
+		}
+	}
+
+	// NOTE: Never evict runs that may already be referenced by a job this frame.
+	TextRun &run = m_text_runs[lru];
+	if (run.image.GetWidth() > 0 && run.last_frame == m_frames_rendered) {
+		return nullptr;
 	}
+	run.image.Destroy();
+	run.text.assign(str, len);
+	run.hash       = hash;
+	run.last_frame = m_frames_rendered;
+	run.color      = color;
+	run.scale      = scale;
 	return nullptr;
 }
 
+void platform::T3DRenderDevice::BlitTextRun(const tiny3d::Image &run, tiny3d::Point xy, const tiny3d::URect &rect)
+{
+	const tiny3d::SInt x0 = mmlMax(xy.x, tiny3d::SInt(rect.a.x));
+	const tiny3d::SInt y0 = mmlMax(xy.y, tiny3d::SInt(rect.a.y));
+	const tiny3d::SInt x1 = mmlMin(xy.x + tiny3d::SInt(run.GetWidth()), tiny3d::SInt(rect.b.x));
+	const tiny3d::SInt y1 = mmlMin(xy.y + tiny3d::SInt(run.GetHeight()), tiny3d::SInt(rect.b.y));
+	for (tiny3d::SInt y = y0; y < y1; ++y) {
+		for (tiny3d::SInt x = x0; x < x1; ++x) {
+			const tiny3d::Color c = run.GetColor(tiny3d::UPoint{ tiny3d::UInt(x - xy.x), tiny3d::UInt(y - xy.y) });
+			if (c.blend != tiny3d::Color::Transparent) {
+				m_dst.SetColor(tiny3d::UPoint{ tiny3d::UInt(x), tiny3d::UInt(y) }, c);
+			}
+		}
+	}
+}
+
 mmlVector<3> platform::T3DRenderDevice::ProjectWorldSpaceToScreenSpace(const mmlVector<3> &v) const
 {
 	const float fwidth = float(m_dst.GetWidth());
@@ -67,6 +215,78 @@ bool platform::T3DRenderDevice::IsFront(const mmlVector<3> &a, const mmlVector<3
 	return (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]) > 0.0f;
 }
 
+tiny3d::UInt platform::T3DRenderDevice::ClipCode(const mmlVector<3> &v) const
+{
+	tiny3d::UInt code = 0;
+	if (v[2] < m_near_z)             { code |= Clip_Near; }
+	if (v[0] >  m_guard_x * v[2])    { code |= Clip_Right; }
+	if (v[0] < -m_guard_x * v[2])    { code |= Clip_Left; }
+	if (v[1] >  m_guard_y * v[2])    { code |= Clip_Up; }
+	if (v[1] < -m_guard_y * v[2])    { code |= Clip_Down; }
+	return code;
+}
+
+float platform::T3DRenderDevice::ClipDistance(const mmlVector<3> &v, tiny3d::UInt plane) const
+{
+	switch (plane) {
+	case Clip_Right: return m_guard_x * v[2] - v[0];
+	case Clip_Left:  return m_guard_x * v[2] + v[0];
+	case Clip_Up:    return m_guard_y * v[2] - v[1];
+	case Clip_Down:  return m_guard_y * v[2] + v[1];
+	default: break;
+	}
+	return v[2] - m_near_z;
+}
+
+tiny3d::UInt platform::T3DRenderDevice::ClipNear(const retro3d::Vertex &a, const retro3d::Vertex &b, const retro3d::Vertex &c, retro3d::Vertex (&out)[RETRO3D_CLIP_VERTEX_MAX], bool &clipped) const
+{
+	const tiny3d::UInt code_a = ClipCode(a.v);
+	const tiny3d::UInt code_b = ClipCode(b.v);
+	const tiny3d::UInt code_c = ClipCode(c.v);
+
+	clipped = false;
+
+	// NOTE: Trivial reject, all vertices are outside of the same plane.
+	if ((code_a & code_b & code_c) != 0) { return 0; }
+
+	out[0] = a;
+	out[1] = b;
+	out[2] = c;
+
+	// NOTE: Trivial accept, the triangle is in front of the near plane and inside the guard band. The rasterizer masks the screen edges.
+	const tiny3d::UInt code_union = code_a | code_b | code_c;
+	if (code_union == 0) { return 3; }
+
+	// NOTE: Sutherland-Hodgman against the planes that are actually crossed. Each plane adds at most one vertex.
+	clipped = true;
+	retro3d::Vertex tmp[RETRO3D_CLIP_VERTEX_MAX];
+	tiny3d::UInt num_out = 3;
+	for (tiny3d::UInt plane = Clip_Near; plane <= Clip_Down && num_out > 2; plane <<= 1) {
+		if ((code_union & plane) == 0) { continue; }
+		tiny3d::UInt num_in = num_out;
+		for (tiny3d::UInt i = 0; i < num_in; ++i) {
+			tmp[i] = out[i];
+		}
+		num_out = 0;
+		for (tiny3d::UInt i = 0, j = num_in - 1; i < num_in; j = i, ++i) {
+			const float di = ClipDistance(tmp[i].v, plane);
+			const float dj = ClipDistance(tmp[j].v, plane);
+			if ((di < 0.0f) != (dj < 0.0f)) {
+				const float x = di / (di - dj);
+				out[num_out++] = {
+					mmlLerp(tmp[i].v, tmp[j].v, x),
+					mmlLerp(tmp[i].t, tmp[j].t, x),
+					mmlLerp(tmp[i].c, tmp[j].c, x)
+				};
+			}
+			if (di >= 0.0f) {
+				out[num_out++] = tmp[i];
+			}
+		}
+	}
+	return num_out;
+}
+
 void platform::T3DRenderDevice::ClearBuffers(tiny3d::URect rect)
 {
 	for (tiny3d::UInt y = rect.a.y; y < rect.b.y; ++y) {
@@ -122,6 +342,9 @@ void platform::T3DRenderDevice::Render(tiny3d::URect rect)
 		case Render3DJob::Frustum:
 			RenderFrustum(rect, m_3d_queue[n], temp_light_array);
 			break;
+		case Render3DJob::Sprites:
+			RenderSprites(rect, m_3d_queue[n]);
+			break;
 		default: break;
 		}
 	}
@@ -129,20 +352,24 @@ void platform::T3DRenderDevice::Render(tiny3d::URect rect)
 
 void platform::T3DRenderDevice::RenderModel(const tiny3d::URect &rect, const platform::T3DRenderDevice::Render3DJob &job, tiny3d::Array< retro3d::Light > &lights)
 {
-	tiny3d::UInt num_lights = 0;
+	tiny3d::UInt num_lights   = 0;
+	uint32_t     num_accepted = 0;
+	uint32_t     num_clipped  = 0;
 
 	const retro3d::Model *model = job.model;
-	const mmlMatrix<4,4> obj_to_view = job.face_camera == false ? m_world_to_view * job.obj_to_world : m_world_to_view * mmlTransform(mmlRotation(job.obj_to_world) * mmlRotation(m_view_to_world), mmlTranslation(job.obj_to_world));
+	const mmlMatrix<4,4> &obj_to_world = *job.obj_to_world;
+	const mmlMatrix<4,4> obj_to_view = job.face_camera == false ? m_world_to_view * obj_to_world : m_world_to_view * mmlTransform(mmlRotation(obj_to_world) * mmlRotation(m_view_to_world), mmlTranslation(obj_to_world));
 	const RenderMode mode = job.render_mode;
 	LightMode        light_mode = job.light_mode;
 
 	// Determine what lights affect the model
 	if (job.light_mode == LightMode_Dynamic) {
-		retro3d::AABB world_model_aabb = model->aabb.ApplyTransform(job.obj_to_world);
+		const mmlMatrix<4,4> world_to_obj = GetWorldToObj(job);
+		retro3d::AABB world_model_aabb = model->aabb.ApplyTransform(obj_to_world);
 		for (tiny3d::UInt l = 0; l < m_num_lights; ++l) {
 //			if (m_lights[l].aabb.Overlaps(world_model_aabb) == true && world_model_aabb.Contains(m_lights[l].aabb) == false) {
 			if (m_lights[l].activation_aabb.Contains(world_model_aabb) > retro3d::Contain_False) {
-				lights[num_lights] = m_lights[l].ApplyTransform(job.world_to_obj);
+				lights[num_lights] = m_lights[l].ApplyTransform(world_to_obj);
 				++num_lights;
 			}
 		}
@@ -214,10 +441,12 @@ void platform::T3DRenderDevice::RenderModel(const tiny3d::URect &rect, const pla
 					a.t = b.t = c.t = mmlVector<2>::Fill(0.0f);
 				}
 
-				// Clip view space triangles against near plane
-				retro3d::Vertex out[4];
-				tiny3d::Vertex final_vtx[4];
-				const tiny3d::UInt num_out = m_near_plane.Clip(a, b, c, out);
+				// Clip view space triangles against near plane and guard band
+				retro3d::Vertex out[RETRO3D_CLIP_VERTEX_MAX];
+				tiny3d::Vertex final_vtx[RETRO3D_CLIP_VERTEX_MAX];
+				bool clipped;
+				const tiny3d::UInt num_out = ClipNear(a, b, c, out, clipped);
+				if (clipped == true) { ++num_clipped; } else { ++num_accepted; }
 
 				// Early exit if clipping does not result in a valid geometric shape
 				if (num_out <= 2) { continue; }
@@ -238,83 +467,48 @@ void platform::T3DRenderDevice::RenderModel(const tiny3d::URect &rect, const pla
 
 				const tiny3d::Texture *tex_mip = texture != nullptr ? (*texture)[DetermineMipLevel(*texture, out[0], out[1], out[2])] : nullptr;
 
-				switch (num_out) {
-				case 4:
-					switch (mode) {
-					case RenderMode_Points:
-						tiny3d::DrawPoint(m_dst, &m_zbuf, &m_zbuf, final_vtx[0], tex_mip, &rect);
-						tiny3d::DrawPoint(m_dst, &m_zbuf, &m_zbuf, final_vtx[1], tex_mip, &rect);
-						tiny3d::DrawPoint(m_dst, &m_zbuf, &m_zbuf, final_vtx[2], tex_mip, &rect);
-						tiny3d::DrawPoint(m_dst, &m_zbuf, &m_zbuf, final_vtx[3], tex_mip, &rect);
-						break;
-					case RenderMode_Lines:
-						tiny3d::DrawLine(m_dst, &m_zbuf, &m_zbuf, final_vtx[0], final_vtx[1], tex_mip, &rect);
-						tiny3d::DrawLine(m_dst, &m_zbuf, &m_zbuf, final_vtx[1], final_vtx[2], tex_mip, &rect);
-						tiny3d::DrawLine(m_dst, &m_zbuf, &m_zbuf, final_vtx[2], final_vtx[3], tex_mip, &rect);
-						tiny3d::DrawLine(m_dst, &m_zbuf, &m_zbuf, final_vtx[3], final_vtx[0], tex_mip, &rect);
-						break;
-					case RenderMode_Polygons:
-						switch (light_mode) {
-						default:
-							tiny3d::DrawTriangle(m_dst, &m_zbuf, &m_zbuf, final_vtx[0], final_vtx[1], final_vtx[2], tex_mip, &rect);
-							tiny3d::DrawTriangle(m_dst, &m_zbuf, &m_zbuf, final_vtx[0], final_vtx[2], final_vtx[3], tex_mip, &rect);
-							break;
-						case LightMode_Lightmap:
-							{
-								tiny3d::LVertex fvl[4] = {
-									{ final_vtx[0].v, final_vtx[0].t, final_vtx[0].t},
-									{ final_vtx[1].v, final_vtx[1].t, final_vtx[1].t},
-									{ final_vtx[2].v, final_vtx[2].t, final_vtx[2].t},
-									{ final_vtx[3].v, final_vtx[3].t, final_vtx[3].t}
-								};
-								const retro3d::Texture *rlmap = model->lightmap.GetShared();
-								const tiny3d::Texture  *tlmap = (*rlmap)[DetermineMipLevel(*rlmap, out[0], out[1], out[2])];
-								tiny3d::DrawTriangle(m_dst, &m_zbuf, &m_zbuf, fvl[0], fvl[1], fvl[2], tex_mip, *tlmap, &rect);
-								tiny3d::DrawTriangle(m_dst, &m_zbuf, &m_zbuf, fvl[0], fvl[2], fvl[3], tex_mip, *tlmap, &rect);
-								break;
-							}
-						}
-						break;
+				switch (mode) {
+				case RenderMode_Points:
+					for (tiny3d::UInt i = 0; i < num_out; ++i) {
+						tiny3d::DrawPoint(m_dst, &m_zbuf, &m_zbuf, final_vtx[i], tex_mip, &rect);
 					}
 					break;
-				case 3:
-					switch (mode) {
-					case RenderMode_Points:
-						tiny3d::DrawPoint(m_dst, &m_zbuf, &m_zbuf, final_vtx[0], tex_mip, &rect);
-						tiny3d::DrawPoint(m_dst, &m_zbuf, &m_zbuf, final_vtx[1], tex_mip, &rect);
-						tiny3d::DrawPoint(m_dst, &m_zbuf, &m_zbuf, final_vtx[2], tex_mip, &rect);
-						break;
-					case RenderMode_Lines:
-						tiny3d::DrawLine(m_dst, &m_zbuf, &m_zbuf, final_vtx[0], final_vtx[1], tex_mip, &rect);
-						tiny3d::DrawLine(m_dst, &m_zbuf, &m_zbuf, final_vtx[1], final_vtx[2], tex_mip, &rect);
-						tiny3d::DrawLine(m_dst, &m_zbuf, &m_zbuf, final_vtx[2], final_vtx[0], tex_mip, &rect);
+				case RenderMode_Lines:
+					for (tiny3d::UInt i = 0, j = num_out - 1; i < num_out; j = i, ++i) {
+						tiny3d::DrawLine(m_dst, &m_zbuf, &m_zbuf, final_vtx[j], final_vtx[i], tex_mip, &rect);
+					}
+					break;
+				case RenderMode_Polygons:
+					switch (light_mode) {
+					default:
+						for (tiny3d::UInt i = 1; i < num_out - 1; ++i) {
+							tiny3d::DrawTriangle(m_dst, &m_zbuf, &m_zbuf, final_vtx[0], final_vtx[i], final_vtx[i + 1], tex_mip, &rect);
+						}
 						break;
-					case RenderMode_Polygons:
-						switch (light_mode) {
-						default:
-							tiny3d::DrawTriangle(m_dst, &m_zbuf, &m_zbuf, final_vtx[0], final_vtx[1], final_vtx[2], tex_mip, &rect);
-							break;
-						case LightMode_Lightmap:
-							{
-								tiny3d::LVertex fvl[3] = {
-									{ final_vtx[0].v, final_vtx[0].t, final_vtx[0].t},
-									{ final_vtx[1].v, final_vtx[1].t, final_vtx[1].t},
-									{ final_vtx[2].v, final_vtx[2].t, final_vtx[2].t}
-								};
-								const retro3d::Texture *rlmap = model->lightmap.GetShared();
-								const tiny3d::Texture  *tlmap = (*rlmap)[DetermineMipLevel(*rlmap, out[0], out[1], out[2])];
-								tiny3d::DrawTriangle(m_dst, &m_zbuf, &m_zbuf, fvl[0], fvl[1], fvl[2], tex_mip, *tlmap, &rect);
-								break;
+					case LightMode_Lightmap:
+						{
+							tiny3d::LVertex fvl[RETRO3D_CLIP_VERTEX_MAX];
+							for (tiny3d::UInt i = 0; i < num_out; ++i) {
+								fvl[i] = { final_vtx[i].v, final_vtx[i].t, final_vtx[i].t };
+							}
+							const retro3d::Texture *rlmap = model->lightmap.GetShared();
+							const tiny3d::Texture  *tlmap = (*rlmap)[DetermineMipLevel(*rlmap, out[0], out[1], out[2])];
+							for (tiny3d::UInt i = 1; i < num_out - 1; ++i) {
+								tiny3d::DrawTriangle(m_dst, &m_zbuf, &m_zbuf, fvl[0], fvl[i], fvl[i + 1], tex_mip, *tlmap, &rect);
 							}
+							break;
 						}
-						break;
 					}
 					break;
-				default: break;
 				}
 			}
 		}
 	}
+	// NOTE: Every render thread traverses every triangle, so only the thread rendering the top strip records statistics.
+	if (rect.a.y == 0) {
+		m_stats.tris_accepted += num_accepted;
+		m_stats.tris_clipped  += num_clipped;
+	}
 }
 
 void platform::T3DRenderDevice::RenderSky(tiny3d::URect rect)
@@ -365,10 +559,11 @@ void platform::T3DRenderDevice::RenderSky(tiny3d::URect rect)
 					a.t = b.t = c.t = mmlVector<2>::Fill(0.0f);
 				}
 
-				// Clip view space triangles against near plane
-				retro3d::Vertex out[4];
-				tiny3d::Vertex final_vtx[4];
-				const tiny3d::UInt num_out = m_near_plane.Clip(a, b, c, out);
+				// Clip view space triangles against near plane and guard band
+				retro3d::Vertex out[RETRO3D_CLIP_VERTEX_MAX];
+				tiny3d::Vertex final_vtx[RETRO3D_CLIP_VERTEX_MAX];
+				bool clipped;
+				const tiny3d::UInt num_out = ClipNear(a, b, c, out, clipped);
 
 				// Project view space vertices to screen space
 				for (tiny3d::UInt i = 0; i < num_out; ++i) {
@@ -383,15 +578,9 @@ void platform::T3DRenderDevice::RenderSky(tiny3d::URect rect)
 
 				const tiny3d::Texture *tex_mip = texture->GetHighestQuality();
 
-				switch (num_out) {
-				case 4:
-					tiny3d::DrawTriangle(m_dst, nullptr, nullptr, final_vtx[0], final_vtx[1], final_vtx[2], tex_mip, &rect);
-					tiny3d::DrawTriangle(m_dst, nullptr, nullptr, final_vtx[0], final_vtx[2], final_vtx[3], tex_mip, &rect);
-					break;
-				case 3:
-					tiny3d::DrawTriangle(m_dst, nullptr, nullptr, final_vtx[0], final_vtx[1], final_vtx[2], tex_mip, &rect);
-					break;
-				default: break;
+				// NOTE: Clipped output is a convex polygon, draw as triangle fan.
+				for (tiny3d::UInt i = 1; i + 1 < num_out; ++i) {
+					tiny3d::DrawTriangle(m_dst, nullptr, nullptr, final_vtx[0], final_vtx[i], final_vtx[i + 1], tex_mip, &rect);
 				}
 			}
 		}
@@ -405,20 +594,24 @@ void platform::T3DRenderDevice::RenderDisplay(const tiny3d::URect &rect, const p
 {
 	const retro3d::Frustum world_view = GetViewFrustum();
 
-	tiny3d::UInt num_lights = 0;
+	tiny3d::UInt num_lights   = 0;
+	uint32_t     num_accepted = 0;
+	uint32_t     num_clipped  = 0;
 
 	const retro3d::DisplayModel *model = job.display_model;
-	const mmlMatrix<4,4> obj_to_view = m_world_to_view * job.obj_to_world;
-	const retro3d::Frustum view_frustum = world_view.ApplyTransform(job.world_to_obj);
+	const mmlMatrix<4,4> &obj_to_world = *job.obj_to_world;
+	const mmlMatrix<4,4> world_to_obj = GetWorldToObj(job);
+	const mmlMatrix<4,4> obj_to_view = m_world_to_view * obj_to_world;
+	const retro3d::Frustum view_frustum = world_view.ApplyTransform(world_to_obj);
 	const RenderMode mode = job.render_mode;
 
 	// Determine what lights affect the model
 	if (job.light_mode == LightMode_Dynamic) {
-		retro3d::AABB world_model_aabb = model->GetAABB().ApplyTransform(job.obj_to_world);
+		retro3d::AABB world_model_aabb = model->GetAABB().ApplyTransform(obj_to_world);
 		for (tiny3d::UInt l = 0; l < m_num_lights; ++l) {
 //			if (m_lights[l].aabb.Overlaps(world_model_aabb) == true && world_model_aabb.Contains(m_lights[l].aabb) == false) {
 			if (m_lights[l].activation_aabb.Contains(world_model_aabb) > retro3d::Contain_False) {
-				lights[num_lights] = m_lights[l].ApplyTransform(job.world_to_obj);
+				lights[num_lights] = m_lights[l].ApplyTransform(world_to_obj);
 				++num_lights;
 			}
 		}
@@ -486,10 +679,12 @@ void platform::T3DRenderDevice::RenderDisplay(const tiny3d::URect &rect, const p
 						c.c = mmlMin(c.c + material->color * dc * lights[l].color, mmlVector<3>::Fill(1.0f));
 					}
 
-					// Clip view space triangles against near plane
-					retro3d::Vertex out[4];
-					tiny3d::Vertex final_vtx[4];
-					const tiny3d::UInt num_out = m_near_plane.Clip(a, b, c, out);
+					// Clip view space triangles against near plane and guard band
+					retro3d::Vertex out[RETRO3D_CLIP_VERTEX_MAX];
+					tiny3d::Vertex final_vtx[RETRO3D_CLIP_VERTEX_MAX];
+					bool clipped;
+					const tiny3d::UInt num_out = ClipNear(a, b, c, out, clipped);
+					if (clipped == true) { ++num_clipped; } else { ++num_accepted; }
 
 					// Early exit if clipping does not result in a valid geometric shape
 					if (num_out <= 2) { continue; }
@@ -510,45 +705,22 @@ void platform::T3DRenderDevice::RenderDisplay(const tiny3d::URect &rect, const p
 
 					const tiny3d::Texture *tex_mip = texture != nullptr ? (*texture)[DetermineMipLevel(*texture, out[0], out[1], out[2])] : nullptr;
 
-					switch (num_out) {
-					case 4:
-						switch (mode) {
-						case RenderMode_Points:
-							tiny3d::DrawPoint(m_dst, &m_zbuf, &m_zbuf, final_vtx[0], tex_mip, &rect);
-							tiny3d::DrawPoint(m_dst, &m_zbuf, &m_zbuf, final_vtx[1], tex_mip, &rect);
-							tiny3d::DrawPoint(m_dst, &m_zbuf, &m_zbuf, final_vtx[2], tex_mip, &rect);
-							tiny3d::DrawPoint(m_dst, &m_zbuf, &m_zbuf, final_vtx[3], tex_mip, &rect);
-							break;
-						case RenderMode_Lines:
-							tiny3d::DrawLine(m_dst, &m_zbuf, &m_zbuf, final_vtx[0], final_vtx[1], tex_mip, &rect);
-							tiny3d::DrawLine(m_dst, &m_zbuf, &m_zbuf, final_vtx[1], final_vtx[2], tex_mip, &rect);
-							tiny3d::DrawLine(m_dst, &m_zbuf, &m_zbuf, final_vtx[2], final_vtx[3], tex_mip, &rect);
-							tiny3d::DrawLine(m_dst, &m_zbuf, &m_zbuf, final_vtx[3], final_vtx[0], tex_mip, &rect);
-							break;
-						case RenderMode_Polygons:
-							tiny3d::DrawTriangle(m_dst, &m_zbuf, &m_zbuf, final_vtx[0], final_vtx[1], final_vtx[2], tex_mip, &rect);
-							tiny3d::DrawTriangle(m_dst, &m_zbuf, &m_zbuf, final_vtx[0], final_vtx[2], final_vtx[3], tex_mip, &rect);
-							break;
+					switch (mode) {
+					case RenderMode_Points:
+						for (tiny3d::UInt i = 0; i < num_out; ++i) {
+							tiny3d::DrawPoint(m_dst, &m_zbuf, &m_zbuf, final_vtx[i], tex_mip, &rect);
 						}
 						break;
-					case 3:
-						switch (mode) {
-						case RenderMode_Points:
-							tiny3d::DrawPoint(m_dst, &m_zbuf, &m_zbuf, final_vtx[0], tex_mip, &rect);
-							tiny3d::DrawPoint(m_dst, &m_zbuf, &m_zbuf, final_vtx[1], tex_mip, &rect);
-							tiny3d::DrawPoint(m_dst, &m_zbuf, &m_zbuf, final_vtx[2], tex_mip, &rect);
-							break;
-						case RenderMode_Lines:
-							tiny3d::DrawLine(m_dst, &m_zbuf, &m_zbuf, final_vtx[0], final_vtx[1], tex_mip, &rect);
-							tiny3d::DrawLine(m_dst, &m_zbuf, &m_zbuf, final_vtx[1], final_vtx[2], tex_mip, &rect);
-							tiny3d::DrawLine(m_dst, &m_zbuf, &m_zbuf, final_vtx[2], final_vtx[0], tex_mip, &rect);
-							break;
-						case RenderMode_Polygons:
-							tiny3d::DrawTriangle(m_dst, &m_zbuf, &m_zbuf, final_vtx[0], final_vtx[1], final_vtx[2], tex_mip, &rect);
-							break;
+					case RenderMode_Lines:
+						for (tiny3d::UInt i = 0, j = num_out - 1; i < num_out; j = i, ++i) {
+							tiny3d::DrawLine(m_dst, &m_zbuf, &m_zbuf, final_vtx[j], final_vtx[i], tex_mip, &rect);
+						}
+						break;
+					case RenderMode_Polygons:
+						for (tiny3d::UInt i = 1; i < num_out - 1; ++i) {
+							tiny3d::DrawTriangle(m_dst, &m_zbuf, &m_zbuf, final_vtx[0], final_vtx[i], final_vtx[i + 1], tex_mip, &rect);
 						}
 						break;
-					default: break;
 					}
 				}
 				poly = poly->GetNext();
@@ -556,6 +728,11 @@ void platform::T3DRenderDevice::RenderDisplay(const tiny3d::URect &rect, const p
 			surface = surface->GetNext();
 		}
 	}
+	// NOTE: Every render thread traverses every triangle, so only the thread rendering the top strip records statistics.
+	if (rect.a.y == 0) {
+		m_stats.tris_accepted += num_accepted;
+		m_stats.tris_clipped  += num_clipped;
+	}
 }
 
 void platform::T3DRenderDevice::RenderAABB(const tiny3d::URect &rect, const platform::T3DRenderDevice::Render3DJob &job, tiny3d::Array< retro3d::Light > &lights)
@@ -566,16 +743,17 @@ void platform::T3DRenderDevice::RenderAABB(const tiny3d::URect &rect, const plat
 		0, 4, 1, 5, 2, 6, 3, 7
 	};
 	mmlVector<3> v[8];
+	const retro3d::AABB &obj_aabb = m_aabb_arena[job.shape_index];
 
 	if (job.world_axis_aligned == true) {
-		retro3d::AABB world_model_aabb = job.obj_aabb.ApplyTransform(job.obj_to_world);
+		retro3d::AABB world_model_aabb = obj_aabb.ApplyTransform(*job.obj_to_world);
 		world_model_aabb.GetCorners(v);
 		for (int i = 0; i < 8; ++i) {
 			v[i] *= m_world_to_view;
 		}
 	} else {
-		const mmlMatrix<4,4> obj_to_view = m_world_to_view * job.obj_to_world;
-		job.obj_aabb.GetCorners(v);
+		const mmlMatrix<4,4> obj_to_view = m_world_to_view * (*job.obj_to_world);
+		obj_aabb.GetCorners(v);
 		for (int i = 0; i < 8; ++i) {
 			v[i] *= obj_to_view;
 		}
@@ -617,8 +795,8 @@ void platform::T3DRenderDevice::RenderFrustum(const tiny3d::URect &rect, const p
 	};
 	mmlVector<3> v[8];
 
-	const mmlMatrix<4,4> obj_to_view = m_world_to_view * job.obj_to_world;
-	job.obj_view_frustum.GetCorners(v);
+	const mmlMatrix<4,4> obj_to_view = m_world_to_view * (*job.obj_to_world);
+	m_frustum_arena[job.shape_index].GetCorners(v);
 	for (int i = 0; i < 8; ++i) {
 		v[i] *= obj_to_view;
 	}
@@ -650,6 +828,107 @@ void platform::T3DRenderDevice::RenderFrustum(const tiny3d::URect &rect, const p
 	}
 }
 
+void platform::T3DRenderDevice::RenderSprites(const tiny3d::URect &rect, const platform::T3DRenderDevice::Render3DJob &job)
+{
+	const SpriteBatchJob &b = m_sprite_batches[job.shape_index];
+	const SpriteQuad *quads = &m_sprite_quads[b.first_quad];
+	const tiny3d::SInt y0 = tiny3d::SInt(rect.a.y);
+	const tiny3d::SInt y1 = tiny3d::SInt(rect.b.y);
+
+	for (tiny3d::UInt i = 0; i < b.num_quads; ++i) {
+		const SpriteQuad &q = quads[i];
+		if (q.y_max < y0 || q.y_min >= y1) { continue; }
+		switch (job.render_mode) {
+		case RenderMode_Points:
+			for (tiny3d::UInt j = 0; j < 4; ++j) {
+				tiny3d::DrawPoint(m_dst, &m_zbuf, &m_zbuf, q.v[j], q.texture, &rect);
+			}
+			break;
+		case RenderMode_Lines:
+			for (tiny3d::UInt j = 0, k = 3; j < 4; k = j, ++j) {
+				tiny3d::DrawLine(m_dst, &m_zbuf, &m_zbuf, q.v[k], q.v[j], q.texture, &rect);
+			}
+			break;
+		case RenderMode_Polygons:
+			tiny3d::DrawTriangle(m_dst, &m_zbuf, &m_zbuf, q.v[0], q.v[1], q.v[2], q.texture, &rect);
+			tiny3d::DrawTriangle(m_dst, &m_zbuf, &m_zbuf, q.v[0], q.v[2], q.v[3], q.texture, &rect);
+			break;
+		}
+	}
+}
+
+void platform::T3DRenderDevice::ExpandSprites( void )
+{
+	tiny3d::UInt total = 0;
+	for (tiny3d::UInt n = 0; n < m_num_sprite_batches; ++n) {
+		total += m_sprite_batches[n].batch.count;
+	}
+	if (total == 0) {
+		return;
+	}
+	if (m_sprite_quads.GetSize() < total) {
+		m_sprite_quads.Create(total);
+	}
+
+	// NOTE: Camera-facing quads are axis aligned in view space, so only the center needs a full transform.
+	const float fwidth          = float(m_dst.GetWidth());
+	const float fheight         = float(m_dst.GetHeight());
+	const float px_per_unit     = fheight * m_hfov_scalar;
+	const float screen_offset_x = fwidth / 2.0f;
+	const float screen_offset_y = fheight / 2.0f;
+	const mmlVector<4> full_uv  = mmlVector<4>(0.0, 0.0, 1.0, 1.0);
+	const mmlVector<3> white    = mmlVector<3>::Fill(1.0f);
+
+	tiny3d::UInt num_quads = 0;
+	for (tiny3d::UInt n = 0; n < m_num_sprite_batches; ++n) {
+		SpriteBatchJob &b = m_sprite_batches[n];
+		b.first_quad = num_quads;
+
+		for (uint32_t i = 0; i < b.batch.count; ++i) {
+			const mmlVector<3> c = b.batch.positions[i] * m_world_to_view;
+			if (c[2] < m_near_z || c[2] > m_far_z) { continue; }
+
+			// NOTE: Project the center and extents once, all four corners share depth.
+			const float inv_z = 1.0f / c[2];
+			const float cx    =  c[0] * inv_z * px_per_unit + screen_offset_x;
+			const float cy    = -c[1] * inv_z * px_per_unit + screen_offset_y;
+			const float hx    = b.batch.sizes[i][0] * 0.5f * inv_z * px_per_unit;
+			const float hy    = b.batch.sizes[i][1] * 0.5f * inv_z * px_per_unit;
+			if (cx + hx < 0.0f || cx - hx >= fwidth || cy + hy < 0.0f || cy - hy >= fheight) { continue; }
+
+			const mmlVector<4> &uv  = b.batch.uv_rects != nullptr ? b.batch.uv_rects[i] : full_uv;
+			const mmlVector<3> &col = b.batch.colors   != nullptr ? b.batch.colors[i]   : white;
+			const tiny3d::Color color = tiny3d::Color{ tiny3d::Byte(col[0] * 255.0f), tiny3d::Byte(col[1] * 255.0f), tiny3d::Byte(col[2] * 255.0f), tiny3d::Color::Solid };
+
+			SpriteQuad &q = m_sprite_quads[num_quads++];
+			const float x[4] = { cx - hx, cx + hx, cx + hx, cx - hx };
+			const float y[4] = { cy - hy, cy - hy, cy + hy, cy + hy };
+			const float u[4] = { uv[0], uv[2], uv[2], uv[0] };
+			const float v[4] = { uv[1], uv[1], uv[3], uv[3] };
+			for (tiny3d::UInt j = 0; j < 4; ++j) {
+				q.v[j].v = tiny3d::Vector3(tiny3d::Real(x[j]), tiny3d::Real(y[j]), tiny3d::Real(c[2]));
+				q.v[j].t = tiny3d::Vector2(tiny3d::Real(u[j]), tiny3d::Real(v[j]));
+				q.v[j].c = color;
+			}
+			q.y_min = tiny3d::SInt(cy - hy);
+			q.y_max = tiny3d::SInt(cy + hy) + 1;
+
+			q.texture = nullptr;
+			if (b.batch.texture != nullptr) {
+				retro3d::Vertex ss[3];
+				for (tiny3d::UInt j = 0; j < 3; ++j) {
+					ss[j].v = mmlVector<3>(double(x[j]), double(y[j]), double(c[2]));
+					ss[j].t = mmlVector<2>(double(u[j]), double(v[j]));
+				}
+				q.texture = (*b.batch.texture)[DetermineMipLevel(*b.batch.texture, ss[0], ss[1], ss[2])];
+			}
+		}
+
+		b.num_quads = num_quads - b.first_quad;
+		m_stats.sprites += uint32_t(b.num_quads);
+	}
+}
+
 void platform::T3DRenderDevice::DepthRender(tiny3d::URect rect)
 {
 	for (tiny3d::UInt y = rect.a.y; y < rect.b.y; ++y) {
@@ -677,16 +956,19 @@ void platform::T3DRenderDevice::Print(tiny3d::URect rect)
 
 		switch (p.type) {
 		case Render2DJob::Text:
-			tiny3d::DrawChars(m_dst, tiny3d::Point{ caret.x + 1, caret.y + 1 }, caret_offset, p.text.c_str(), tiny3d::UInt(p.text.size()), tiny3d::Color{0,0,0,tiny3d::Color::Solid}, 1, &rect);
-			caret = tiny3d::DrawChars(m_dst, caret, caret_offset, p.text.c_str(), tiny3d::UInt(p.text.size()), p.color, 1, &rect);
+			tiny3d::DrawChars(m_dst, tiny3d::Point{ caret.x + 1, caret.y + 1 }, caret_offset, &m_text_arena[p.text_offset], p.text_length, tiny3d::Color{0,0,0,tiny3d::Color::Solid}, 1, &rect);
+			caret = tiny3d::DrawChars(m_dst, caret, caret_offset, &m_text_arena[p.text_offset], p.text_length, p.color, 1, &rect);
 			break;
 		case Render2DJob::TextFree:
-			//tiny3d::DrawChars(m_dst, tiny3d::Point{ p.xy.x + 1, p.xy.y + 1 }, p.xy.x, p.text.c_str(), tiny3d::UInt(p.text.size()), tiny3d::Color{0,0,0,tiny3d::Color::Solid}, 1, &rect);
-			tiny3d::DrawChars(m_dst, p.xy, p.xy.x, p.text.c_str(), tiny3d::UInt(p.text.size()), p.color, p.scale, &rect);
+			//tiny3d::DrawChars(m_dst, tiny3d::Point{ p.xy.x + 1, p.xy.y + 1 }, p.xy.x, &m_text_arena[p.text_offset], p.text_length, tiny3d::Color{0,0,0,tiny3d::Color::Solid}, 1, &rect);
+			tiny3d::DrawChars(m_dst, p.xy, p.xy.x, &m_text_arena[p.text_offset], p.text_length, p.color, p.scale, &rect);
 			break;
 		case Render2DJob::Overlay:
 			tiny3d::DrawRegion(m_dst, p.dst_rect, *p.overlay, p.src_rect, &rect);
 			break;
+		case Render2DJob::TextRun:
+			BlitTextRun(*p.text_run, p.xy, rect);
+			break;
 		case Render2DJob::Line:
 			break;
 		case Render2DJob::BoxLines:
@@ -699,9 +981,16 @@ void platform::T3DRenderDevice::Print(tiny3d::URect rect)
 
 void platform::T3DRenderDevice::ClearJobBuffers( void )
 {
-	m_num_3d_items = 0;
-	m_num_2d_items = 0;
-	m_num_lights   = 0;
+	m_num_3d_items       = 0;
+	m_num_2d_items       = 0;
+	m_num_transforms     = 0;
+	m_num_aabbs          = 0;
+	m_num_frustums       = 0;
+	m_text_arena_size    = 0;
+	m_num_sprite_batches = 0;
+	m_num_lights         = 0;
+	m_last_stats         = m_stats;
+	m_stats              = FrameStats{ 0, 0, 0, 0, 0, 0, 0, 0, 0 };
 }
 
 void platform::T3DRenderDevice::UpdateViewFrustum( void )
@@ -731,10 +1020,18 @@ void platform::T3DRenderDevice::UpdateViewFrustum( void )
 platform::T3DRenderDevice::T3DRenderDevice( void ) :
 	m_dst(), m_zbuf(),
 	m_world_to_view(mmlMatrix<4,4>::Identity()), m_view_to_world(mmlMatrix<4,4>::Identity()), m_world_to_view_ptr(&m_world_to_view),
-	m_near_z(1.0f), m_far_z(1.0f), m_hfov(1.0f), m_aspect_ratio(1.0f), m_hfov_scalar(1.0f), m_near_plane(mmlVector<3>(0.0, 0.0, double(m_near_z)), retro3d::Transform::GetWorldForward()),
+	m_near_z(1.0f), m_far_z(1.0f), m_hfov(1.0f), m_aspect_ratio(1.0f), m_hfov_scalar(1.0f), m_guard_x(1.0f), m_guard_y(1.0f), m_near_plane(mmlVector<3>(0.0, 0.0, double(m_near_z)), retro3d::Transform::GetWorldForward()),
 	m_2d_queue(512), m_num_2d_items(0),
 	m_3d_queue(512), m_num_3d_items(0),
+	m_transform_arena(1024), m_num_transforms(0),
+	m_aabb_arena(256), m_num_aabbs(0),
+	m_frustum_arena(16), m_num_frustums(0),
+	m_text_arena(16384), m_text_arena_size(0),
+	m_text_runs(32),
+	m_sprite_batches(64), m_num_sprite_batches(0),
+	m_sprite_quads(0),
 	m_lights(16), m_num_lights(0),
+	m_stats{ 0, 0, 0, 0, 0, 0, 0, 0, 0 }, m_last_stats{ 0, 0, 0, 0, 0, 0, 0, 0, 0 },
 	m_frames_rendered(0),
 	m_skybox(*retro3d::Model::Library.Fetch("Default.Cube.Model").GetShared()),
 	m_mip_ratio(4.0f),
@@ -786,6 +1083,9 @@ void platform::T3DRenderDevice::SetDepthClip(float near_z, float far_z, float ho
 	m_hfov         = mmlClamp(0.1f, hori_fov, mmlPI - 0.1f);
 	m_aspect_ratio = m_dst.GetWidth() > 0 ? m_dst.GetHeight() / float(m_dst.GetWidth()) : 1.0f;
 	m_hfov_scalar  = 1.0f / tanf(m_hfov * 0.5f);
+	const float px_per_unit = mmlMax(1.0f, float(m_dst.GetHeight())) * m_hfov_scalar;
+	m_guard_x      = (m_dst.GetWidth() * 0.5f + RETRO3D_GUARD_BAND) / px_per_unit;
+	m_guard_y      = (m_dst.GetHeight() * 0.5f + RETRO3D_GUARD_BAND) / px_per_unit;
 	UpdateViewFrustum();
 }
 
@@ -889,10 +1189,31 @@ void platform::T3DRenderDevice::RenderSpritePlane(const retro3d::Model &sprite_p
 	}
 }
 
+void platform::T3DRenderDevice::RenderSprites(const retro3d::RenderDevice::SpriteBatch &batch, retro3d::RenderDevice::RenderMode render_mode)
+{
+	if (batch.count == 0 || batch.positions == nullptr || batch.sizes == nullptr) {
+		return;
+	}
+	if (m_num_sprite_batches >= m_sprite_batches.GetSize()) {
+		++m_stats.jobs_dropped;
+		return;
+	}
+	Render3DJob *job = Add3DJob(Render3DJob::Sprites, static_cast<const mmlMatrix<4,4>*>(nullptr), LightMode_Fullbright);
+	if (job != nullptr) {
+		SpriteBatchJob &b = m_sprite_batches[m_num_sprite_batches];
+		b.batch      = batch;
+		b.first_quad = 0;
+		b.num_quads  = 0;
+		m_stats.bytes_submitted += uint32_t(sizeof(SpriteBatchJob));
+		job->shape_index = m_num_sprite_batches++;
+		job->render_mode = render_mode;
+	}
+}
+
 void platform::T3DRenderDevice::RenderLight(const retro3d::Light &light)
 {
 	if (m_num_lights >= m_lights.GetSize()) {
-		RenderText(retro_text_err("light overflow\n"));
+		Add2DText(Render2DJob::Text, "light overflow\n", 15, tiny3d::Point{ 0,0 }, tiny3d::Color{ 255,0,0,tiny3d::Color::Solid });
 	} else {
 		m_lights[m_num_lights++] = light;
 	}
@@ -900,9 +1221,15 @@ void platform::T3DRenderDevice::RenderLight(const retro3d::Light &light)
 
 void platform::T3DRenderDevice::RenderAABB(const retro3d::AABB &aabb, const mmlMatrix<4,4> &obj_to_world, const mmlVector<3> &color, bool world_axis_aligned)
 {
+	if (m_num_aabbs >= m_aabb_arena.GetSize()) {
+		++m_stats.jobs_dropped;
+		return;
+	}
 	Render3DJob *job = Add3DJob(Render3DJob::AABB, obj_to_world, LightMode_Fullbright);
 	if (job != nullptr) {
-		job->obj_aabb           = aabb;
+		m_aabb_arena[m_num_aabbs] = aabb;
+		m_stats.bytes_submitted += uint32_t(sizeof(retro3d::AABB));
+		job->shape_index        = m_num_aabbs++;
 		job->color              = tiny3d::Color{ tiny3d::Byte(color[0] * 255.0f), tiny3d::Byte(color[1] * 255.0f), tiny3d::Byte(color[2] * 255.0f), tiny3d::Color::Solid };
 		job->world_axis_aligned = world_axis_aligned;
 	}
@@ -910,9 +1237,15 @@ void platform::T3DRenderDevice::RenderAABB(const retro3d::AABB &aabb, const mmlM
 
 void platform::T3DRenderDevice::RenderAABB(const retro3d::AABB &aabb, const mmlMatrix<4,4> *obj_to_world, const mmlVector<3> &color, bool world_axis_aligned)
 {
+	if (m_num_aabbs >= m_aabb_arena.GetSize()) {
+		++m_stats.jobs_dropped;
+		return;
+	}
 	Render3DJob *job = Add3DJob(Render3DJob::AABB, obj_to_world, LightMode_Fullbright);
 	if (job != nullptr) {
-		job->obj_aabb           = aabb;
+		m_aabb_arena[m_num_aabbs] = aabb;
+		m_stats.bytes_submitted += uint32_t(sizeof(retro3d::AABB));
+		job->shape_index        = m_num_aabbs++;
 		job->color              = tiny3d::Color{ tiny3d::Byte(color[0] * 255.0f), tiny3d::Byte(color[1] * 255.0f), tiny3d::Byte(color[2] * 255.0f), tiny3d::Color::Solid };
 		job->world_axis_aligned = world_axis_aligned;
 	}
@@ -920,19 +1253,31 @@ void platform::T3DRenderDevice::RenderAABB(const retro3d::AABB &aabb, const mmlM
 
 void platform::T3DRenderDevice::RenderViewFrustum(const retro3d::Frustum &frustum, const mmlMatrix<4,4> &obj_to_world, const mmlVector<3> &color)
 {
+	if (m_num_frustums >= m_frustum_arena.GetSize()) {
+		++m_stats.jobs_dropped;
+		return;
+	}
 	Render3DJob *job = Add3DJob(Render3DJob::Frustum, obj_to_world, LightMode_Fullbright);
 	if (job != nullptr) {
-		job->obj_view_frustum = frustum;
-		job->color            = tiny3d::Color{ tiny3d::Byte(color[0] * 255.0f), tiny3d::Byte(color[1] * 255.0f), tiny3d::Byte(color[2] * 255.0f), tiny3d::Color::Solid };
+		m_frustum_arena[m_num_frustums] = frustum;
+		m_stats.bytes_submitted += uint32_t(sizeof(retro3d::Frustum));
+		job->shape_index = m_num_frustums++;
+		job->color       = tiny3d::Color{ tiny3d::Byte(color[0] * 255.0f), tiny3d::Byte(color[1] * 255.0f), tiny3d::Byte(color[2] * 255.0f), tiny3d::Color::Solid };
 	}
 }
 
 void platform::T3DRenderDevice::RenderViewFrustum(const retro3d::Frustum &frustum, const mmlMatrix<4,4> *obj_to_world, const mmlVector<3> &color)
 {
+	if (m_num_frustums >= m_frustum_arena.GetSize()) {
+		++m_stats.jobs_dropped;
+		return;
+	}
 	Render3DJob *job = Add3DJob(Render3DJob::Frustum, obj_to_world, LightMode_Fullbright);
 	if (job != nullptr) {
-		job->obj_view_frustum = frustum;
-		job->color            = tiny3d::Color{ tiny3d::Byte(color[0] * 255.0f), tiny3d::Byte(color[1] * 255.0f), tiny3d::Byte(color[2] * 255.0f), tiny3d::Color::Solid };
+		m_frustum_arena[m_num_frustums] = frustum;
+		m_stats.bytes_submitted += uint32_t(sizeof(retro3d::Frustum));
+		job->shape_index = m_num_frustums++;
+		job->color       = tiny3d::Color{ tiny3d::Byte(color[0] * 255.0f), tiny3d::Byte(color[1] * 255.0f), tiny3d::Byte(color[2] * 255.0f), tiny3d::Color::Solid };
 	}
 }
 
@@ -948,63 +1293,68 @@ void platform::T3DRenderDevice::RenderOverlay(const tiny3d::Overlay &overlay, co
 
 retro3d::RenderDevice &platform::T3DRenderDevice::RenderText(const std::string &str, const mmlVector<3> &color)
 {
-	Render2DJob *job = Add2DJob(Render2DJob::Text, tiny3d::Point{ 0,0 }, tiny3d::Color{ tiny3d::Byte(color[0] * 255.0f), tiny3d::Byte(color[1] * 255.0f), tiny3d::Byte(color[2] * 255.0f), tiny3d::Color::Solid });
-	if (job != nullptr) {
-		job->text = str;
-	}
+	Add2DText(Render2DJob::Text, str.c_str(), tiny3d::UInt(str.size()), tiny3d::Point{ 0,0 }, tiny3d::Color{ tiny3d::Byte(color[0] * 255.0f), tiny3d::Byte(color[1] * 255.0f), tiny3d::Byte(color[2] * 255.0f), tiny3d::Color::Solid });
 	return *this;
 }
 
 retro3d::RenderDevice &platform::T3DRenderDevice::RenderText(int64_t n, const mmlVector<3> &color)
 {
-	std::ostringstream sout;
-	sout << n;
-	return RenderText(sout.str(), color);
+	char buf[32];
+	const std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), n);
+	Add2DText(Render2DJob::Text, buf, tiny3d::UInt(r.ptr - buf), tiny3d::Point{ 0,0 }, tiny3d::Color{ tiny3d::Byte(color[0] * 255.0f), tiny3d::Byte(color[1] * 255.0f), tiny3d::Byte(color[2] * 255.0f), tiny3d::Color::Solid });
+	return *this;
 }
 
 retro3d::RenderDevice &platform::T3DRenderDevice::RenderText(uint64_t n, const mmlVector<3> &color)
 {
-	std::ostringstream sout;
-	sout << n;
-	return RenderText(sout.str(), color);
+	char buf[32];
+	const std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), n);
+	Add2DText(Render2DJob::Text, buf, tiny3d::UInt(r.ptr - buf), tiny3d::Point{ 0,0 }, tiny3d::Color{ tiny3d::Byte(color[0] * 255.0f), tiny3d::Byte(color[1] * 255.0f), tiny3d::Byte(color[2] * 255.0f), tiny3d::Color::Solid });
+	return *this;
 }
 
 retro3d::RenderDevice &platform::T3DRenderDevice::RenderText(double n, const mmlVector<3> &color)
 {
-	std::ostringstream sout;
-	sout << std::fixed << std::setprecision(3) << n;
-	return RenderText(sout.str(), color);
+	char buf[64];
+	std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), n, std::chars_format::fixed, 3);
+	if (r.ec != std::errc()) { // NOTE: Too large to print in fixed notation.
+		r = std::to_chars(buf, buf + sizeof(buf), n, std::chars_format::scientific, 3);
+	}
+	Add2DText(Render2DJob::Text, buf, tiny3d::UInt(r.ptr - buf), tiny3d::Point{ 0,0 }, tiny3d::Color{ tiny3d::Byte(color[0] * 255.0f), tiny3d::Byte(color[1] * 255.0f), tiny3d::Byte(color[2] * 255.0f), tiny3d::Color::Solid });
+	return *this;
 }
 
 retro3d::RenderDevice &platform::T3DRenderDevice::RenderText(const std::string &str, tiny3d::Point xy, uint32_t scale, const mmlVector<3> &color)
 {
-	Render2DJob *job = Add2DJob(Render2DJob::TextFree, xy, tiny3d::Color{ tiny3d::Byte(color[0] * 255.0f), tiny3d::Byte(color[1] * 255.0f), tiny3d::Byte(color[2] * 255.0f), tiny3d::Color::Solid });
-	if (job != nullptr) {
-		job->text = str;
-		job->scale = scale;
-	}
+	AddTextFree(str.c_str(), tiny3d::UInt(str.size()), xy, scale, tiny3d::Color{ tiny3d::Byte(color[0] * 255.0f), tiny3d::Byte(color[1] * 255.0f), tiny3d::Byte(color[2] * 255.0f), tiny3d::Color::Solid });
 	return *this;
 }
 
 retro3d::RenderDevice &platform::T3DRenderDevice::RenderText(int64_t n, tiny3d::Point xy, uint32_t scale, const mmlVector<3> &color)
 {
-	std::ostringstream sout;
-	sout << n;
-	return RenderText(sout.str(), xy, scale, color);
+	char buf[32];
+	const std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), n);
+	AddTextFree(buf, tiny3d::UInt(r.ptr - buf), xy, scale, tiny3d::Color{ tiny3d::Byte(color[0] * 255.0f), tiny3d::Byte(color[1] * 255.0f), tiny3d::Byte(color[2] * 255.0f), tiny3d::Color::Solid });
+	return *this;
 }
 
 retro3d::RenderDevice &platform::T3DRenderDevice::RenderText(uint64_t n, tiny3d::Point xy, uint32_t scale, const mmlVector<3> &color)
 {
-	std::ostringstream sout;
-	sout << n;
-	return RenderText(sout.str(), xy, scale, color);
+	char buf[32];
+	const std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), n);
+	AddTextFree(buf, tiny3d::UInt(r.ptr - buf), xy, scale, tiny3d::Color{ tiny3d::Byte(color[0] * 255.0f), tiny3d::Byte(color[1] * 255.0f), tiny3d::Byte(color[2] * 255.0f), tiny3d::Color::Solid });
+	return *this;
 }
 
 retro3d::RenderDevice &platform::T3DRenderDevice::RenderText(double n, tiny3d::Point xy, uint32_t scale, const mmlVector<3> &color)
 {
-	std::ostringstream sout;
-	sout << std::fixed << std::setprecision(3) << n;
-	return RenderText(sout.str(), xy, scale, color);
+	char buf[64];
+	std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), n, std::chars_format::fixed, 3);
+	if (r.ec != std::errc()) { // NOTE: Too large to print in fixed notation.
+		r = std::to_chars(buf, buf + sizeof(buf), n, std::chars_format::scientific, 3);
+	}
+	AddTextFree(buf, tiny3d::UInt(r.ptr - buf), xy, scale, tiny3d::Color{ tiny3d::Byte(color[0] * 255.0f), tiny3d::Byte(color[1] * 255.0f), tiny3d::Byte(color[2] * 255.0f), tiny3d::Color::Solid });
+	return *this;
 }
 
 void platform::T3DRenderDevice::ExecuteJobs(tiny3d::SInt thread_num, tiny3d::SInt dst_height_per_thread, tiny3d::SInt video_height_per_thread, bool update_video_out)
@@ -1012,14 +1362,23 @@ void platform::T3DRenderDevice::ExecuteJobs(tiny3d::SInt thread_num, tiny3d::SIn
 	tiny3d::URect thread_mask = { { tiny3d::UInt(0), tiny3d::UInt(thread_num * dst_height_per_thread)   }, { tiny3d::UInt(m_dst.GetWidth()),         tiny3d::UInt((thread_num + 1) * dst_height_per_thread)   } };
 	tiny3d::URect out_mask    = { { tiny3d::UInt(0), tiny3d::UInt(thread_num * video_height_per_thread) }, { tiny3d::UInt(GetEngine()->GetVideo()->GetWindowWidth()), tiny3d::UInt((thread_num + 1) * video_height_per_thread) } };
 	// TODO: Clearing buffers HERE
-	Render(thread_mask);
+	{
+		RETRO3D_PROFILE_SCOPE("Render");
+		Render(thread_mask);
+	}
 	if (m_depth_render == true) {
+		RETRO3D_PROFILE_SCOPE("DepthRender");
 		DepthRender(thread_mask);
 	} else if (m_render_skybox == true) { // render sky only if enabled AND depth rendering not enabled
+		RETRO3D_PROFILE_SCOPE("RenderSky");
 		RenderSky(thread_mask);
 	}
-	Print(thread_mask);
+	{
+		RETRO3D_PROFILE_SCOPE("Print");
+		Print(thread_mask);
+	}
 	if (update_video_out == true) {
+		RETRO3D_PROFILE_SCOPE("FromImage");
 		GetEngine()->GetVideo()->FromImage(m_dst, out_mask);
 	}
 	ClearBuffers(thread_mask); // TODO, NOTE, BUG, HACK: Do NOT clear buffers here (I am only doing this to enable Debug_RenderTriangle).
@@ -1034,6 +1393,8 @@ void platform::T3DRenderDevice::FinishRender(bool update_video_out)
 	const tiny3d::SInt dst_height_per_thread   = tiny3d::SInt(m_dst.GetHeight()) / num_threads;
 	const tiny3d::SInt video_height_per_thread = tiny3d::SInt(GetEngine()->GetVideo()->GetWindowHeight()) / num_threads;
 
+	ExpandSprites();
+
 	m_render_threads.Create(num_threads);
 
 	for (tiny3d::SInt thread = 0; thread < num_threads; ++thread) {
@@ -1138,6 +1499,11 @@ retro3d::Frustum platform::T3DRenderDevice::GetViewFrustum( void ) const
 	return m_object_space_view_frustum.ApplyTransform(m_view_to_world);
 }
 
+retro3d::RenderDevice::FrameStats platform::T3DRenderDevice::GetFrameStats( void ) const
+{
+	return m_last_stats;
+}
+
 void platform::T3DRenderDevice::Debug_RenderTriangle(const retro3d::Vertex &A, const retro3d::Vertex &B, const retro3d::Vertex &C, const mmlMatrix<4,4> &obj_to_world, const mmlMatrix<4,4> &world_to_view, const retro3d::Texture *texture, LightMode light_mode)
 {
 	const mmlMatrix<4,4> obj_to_view = world_to_view * obj_to_world;
@@ -1187,10 +1553,11 @@ void platform::T3DRenderDevice::Debug_RenderTriangle(const retro3d::Vertex &A, c
 	b.t = B.t;
 	c.t = C.t;
 
-	// Clip view space triangles against near plane
-	retro3d::Vertex out[4];
-	tiny3d::Vertex final_vtx[4];
-	const tiny3d::UInt num_out = m_near_plane.Clip(a, b, c, out);
+	// Clip view space triangles against near plane and guard band
+	retro3d::Vertex out[RETRO3D_CLIP_VERTEX_MAX];
+	tiny3d::Vertex final_vtx[RETRO3D_CLIP_VERTEX_MAX];
+	bool clipped;
+	const tiny3d::UInt num_out = ClipNear(a, b, c, out, clipped);
 
 	// Early exit if clipping does not result in a valid geometric shape
 	if (num_out <= 2) { return; }
@@ -1211,14 +1578,7 @@ void platform::T3DRenderDevice::Debug_RenderTriangle(const retro3d::Vertex &A, c
 
 	const tiny3d::Texture *tex_mip = texture != nullptr ? (*texture)[DetermineMipLevel(*texture, out[0], out[1], out[2])] : nullptr;
 
-	switch (num_out) {
-	case 4:
-		tiny3d::DrawTriangle(m_dst, &m_zbuf, &m_zbuf, final_vtx[0], final_vtx[1], final_vtx[2], tex_mip);
-		tiny3d::DrawTriangle(m_dst, &m_zbuf, &m_zbuf, final_vtx[0], final_vtx[2], final_vtx[3], tex_mip);
-		break;
-	case 3:
-		tiny3d::DrawTriangle(m_dst, &m_zbuf, &m_zbuf, final_vtx[0], final_vtx[1], final_vtx[2], tex_mip);
-		break;
-	default: break;
+	for (tiny3d::UInt i = 1; i < num_out - 1; ++i) {
+		tiny3d::DrawTriangle(m_dst, &m_zbuf, &m_zbuf, final_vtx[0], final_vtx[i], final_vtx[i + 1], tex_mip);
 	}
 }
@@ -2,15 +2,20 @@
 #define RETRO_T3D_RENDER_H
 
 #include <thread>
+#include <string>
 #include "../frontend/retro_render_device.h"
 #include "../api/tiny3d/tiny_image.h"
 
+#define RETRO3D_CLIP_VERTEX_MAX 8    // A triangle clipped against the near plane and the four guard band planes has at most 8 vertices.
+#define RETRO3D_GUARD_BAND      1024 // Pixels outside of each screen edge where geometry is left for the rasterizer to mask rather than clipped.
+
 namespace platform
 {
 
 class T3DRenderDevice : public retro3d::RenderDevice
 {
 private:
+	// NOTE: Jobs are kept small and trivially copyable. Large type-specific payloads (matrices, AABBs, frustums, text) live in per-frame arenas and are referred to by the job.
 	struct Render3DJob
 	{
 		enum Type {
@@ -18,23 +23,23 @@ private:
 			DisplayModel, // Render a DisplayModel (BSP).
 			Text, // Render 3D text.
 			AABB, // Render an AABB as lines.
-			Frustum // Render a frustum as lines.
+			Frustum, // Render a frustum as lines.
+			Sprites // Render a batch of camera-facing quads.
 		};
 
-		const retro3d::Model        *model;
-		const retro3d::DisplayModel *display_model;
-		RenderMode                   render_mode;
-		std::string                  text;
-		retro3d::AABB                obj_aabb;
-		retro3d::Frustum             obj_view_frustum;
-		tiny3d::Color                color;
-		Type                         type;
-		mmlMatrix<4,4>               obj_to_world;
-		mmlMatrix<4,4>               world_to_obj;
-		const mmlMatrix<4,4>        *obj_to_world_ptr;
-		LightMode                    light_mode;
-		bool                         world_axis_aligned;
-		bool                         face_camera;
+		union {
+			const retro3d::Model        *model;         // Model
+			const retro3d::DisplayModel *display_model; // DisplayModel
+			tiny3d::UInt                 shape_index;   // AABB (index into m_aabb_arena), Frustum (index into m_frustum_arena), Sprites (index into m_sprite_batches)
+		};
+		const mmlMatrix<4,4> *obj_to_world; // Points into m_transform_arena or to user memory.
+		const mmlMatrix<4,4> *world_to_obj; // Points into m_transform_arena. Null if the job did not need it at submission (see Add3DJob).
+		tiny3d::Color         color;
+		Type                  type;
+		RenderMode            render_mode;
+		LightMode             light_mode;
+		bool                  world_axis_aligned;
+		bool                  face_camera;
 	};
 
 	struct Render2DJob // in separate array
@@ -43,21 +48,61 @@ private:
 			Text, // Text, aligned top-left of screen
 			TextFree, // Text, position is user-defined.
 			Overlay, // Bit image.
+			TextRun, // Pre-rasterized text, position is user-defined.
 			Line, // A line.
 			BoxLines, // A box made of lines.
 			BoxFilled // A filled box.
 		};
 
+		const tiny3d::Overlay *overlay;
+		const tiny3d::Image   *text_run; // Points into m_text_runs.
+		retro3d::Rect          src_rect;
+		retro3d::Rect          dst_rect;
+		tiny3d::UInt           text_offset; // Index into m_text_arena.
+		tiny3d::UInt           text_length;
+		tiny3d::Color          color;
+		tiny3d::Point          xy;
+		Type                   type;
+		uint32_t               scale;
+		bool                   to_console;
+	};
+
+	// NOTE: A cached, pre-rasterized line of free-floating text. Rasterized once a line has been submitted unchanged two frames in a row.
+	struct TextRun
+	{
+		tiny3d::Image image;
 		std::string   text;
-		tiny3d::Color color;
-		tiny3d::Point xy;
-		Type          type;
-		uint32_t      scale;
-		bool          to_console;
+		uint64_t      hash       = 0;
+		tiny3d::UInt  last_frame = 0;
+		tiny3d::Color color      = tiny3d::Color{ 0, 0, 0, tiny3d::Color::Transparent };
+		uint32_t      scale      = 0;
+	};
 
-		const tiny3d::Overlay *overlay;
-		retro3d::Rect src_rect;
-		retro3d::Rect dst_rect;
+	// NOTE: A sprite batch and the range of its expanded quads in m_sprite_quads.
+	struct SpriteBatchJob
+	{
+		SpriteBatch  batch;
+		tiny3d::UInt first_quad;
+		tiny3d::UInt num_quads;
+	};
+
+	// NOTE: A sprite expanded to a screen space quad. The row span lets each render strip reject quads without touching the vertices.
+	struct SpriteQuad
+	{
+		tiny3d::Vertex         v[4];
+		const tiny3d::Texture *texture;
+		tiny3d::SInt           y_min;
+		tiny3d::SInt           y_max;
+	};
+
+	// NOTE: Outcodes for the near plane and the guard band planes.
+	enum ClipPlane
+	{
+		Clip_Near  = 1,
+		Clip_Right = 2,
+		Clip_Left  = 4,
+		Clip_Up    = 8,
+		Clip_Down  = 16
 	};
 
 	enum BoxSides
@@ -71,49 +116,64 @@ private:
 		Side_Count
 	};
 
-	struct Jobs
-	{
-		tiny3d::Array<Render2DJob>     m_2d_queue;
-		tiny3d::UInt                   m_num_2d_items;
-		tiny3d::Array<Render3DJob>     m_3d_queue;
-		tiny3d::UInt                   m_num_3d_items;
-		tiny3d::Array<retro3d::Light>  m_lights;
-		tiny3d::UInt                   m_num_lights;
-	};
-
 private:
-	tiny3d::Image                  m_dst;
-	tiny3d::Array<float>           m_zbuf;
-	mmlMatrix<4,4>                 m_world_to_view;
-	mmlMatrix<4,4>                 m_view_to_world;
-	const mmlMatrix<4,4>          *m_world_to_view_ptr;
-	float                          m_near_z;
-	float                          m_far_z;
-	float                          m_hfov;
-	float                          m_aspect_ratio;
-	float                          m_hfov_scalar;
-	retro3d::Plane                 m_near_plane;
-	tiny3d::Array<Render2DJob>     m_2d_queue;
-	tiny3d::UInt                   m_num_2d_items;
-	tiny3d::Array<Render3DJob>     m_3d_queue;
-	tiny3d::UInt                   m_num_3d_items;
-	tiny3d::Array<retro3d::Light>  m_lights;
-	tiny3d::UInt                   m_num_lights;
-	retro3d::Array<std::thread>    m_render_threads;
-	tiny3d::UInt                   m_frames_rendered;
-	retro3d::Model                 m_skybox;
-	retro3d::Frustum               m_object_space_view_frustum;
-	float                          m_mip_ratio;
-	bool                           m_depth_render;
-	bool                           m_render_skybox;
+	tiny3d::Image                   m_dst;
+	tiny3d::Array<float>            m_zbuf;
+	mmlMatrix<4,4>                  m_world_to_view;
+	mmlMatrix<4,4>                  m_view_to_world;
+	const mmlMatrix<4,4>           *m_world_to_view_ptr;
+	float                           m_near_z;
+	float                           m_far_z;
+	float                           m_hfov;
+	float                           m_aspect_ratio;
+	float                           m_hfov_scalar;
+	float                           m_guard_x; // Guard band as view space slope (x/z).
+	float                           m_guard_y; // Guard band as view space slope (y/z).
+	retro3d::Plane                  m_near_plane;
+	tiny3d::Array<Render2DJob>      m_2d_queue;
+	tiny3d::UInt                    m_num_2d_items;
+	tiny3d::Array<Render3DJob>      m_3d_queue;
+	tiny3d::UInt                    m_num_3d_items;
+	tiny3d::Array<mmlMatrix<4,4>>   m_transform_arena;
+	tiny3d::UInt                    m_num_transforms;
+	tiny3d::Array<retro3d::AABB>    m_aabb_arena;
+	tiny3d::UInt                    m_num_aabbs;
+	tiny3d::Array<retro3d::Frustum> m_frustum_arena;
+	tiny3d::UInt                    m_num_frustums;
+	tiny3d::Array<char>             m_text_arena;
+	tiny3d::UInt                    m_text_arena_size;
+	tiny3d::Array<TextRun>          m_text_runs;
+	tiny3d::Array<SpriteBatchJob>   m_sprite_batches;
+	tiny3d::UInt                    m_num_sprite_batches;
+	tiny3d::Array<SpriteQuad>       m_sprite_quads;
+	tiny3d::Array<retro3d::Light>   m_lights;
+	tiny3d::UInt                    m_num_lights;
+	FrameStats                      m_stats;
+	FrameStats                      m_last_stats;
+	retro3d::Array<std::thread>     m_render_threads;
+	tiny3d::UInt                    m_frames_rendered;
+	retro3d::Model                  m_skybox;
+	retro3d::Frustum                m_object_space_view_frustum;
+	float                           m_mip_ratio;
+	bool                            m_depth_render;
+	bool                            m_render_skybox;
 
 private:
 	Render3DJob  *Add3DJob(Render3DJob::Type type, const mmlMatrix<4,4> &obj_to_world, LightMode light_mode);
 	Render3DJob  *Add3DJob(Render3DJob::Type type, const mmlMatrix<4,4> *obj_to_world, LightMode light_mode);
 	Render2DJob  *Add2DJob(Render2DJob::Type type, tiny3d::Point xy, tiny3d::Color color);
+	Render2DJob  *Add2DText(Render2DJob::Type type, const char *str, tiny3d::UInt len, tiny3d::Point xy, tiny3d::Color color);
+	mmlMatrix<4,4> *AllocTransform( void );
+	tiny3d::UInt  InternText(const char *str, tiny3d::UInt len, tiny3d::UInt &offset);
+	Render2DJob  *AddTextFree(const char *str, tiny3d::UInt len, tiny3d::Point xy, uint32_t scale, tiny3d::Color color);
+	const tiny3d::Image *FindTextRun(const char *str, tiny3d::UInt len, uint32_t scale, tiny3d::Color color);
+	void          BlitTextRun(const tiny3d::Image &run, tiny3d::Point xy, const tiny3d::URect &rect);
+	mmlMatrix<4,4> GetWorldToObj(const Render3DJob &job) const;
 	mmlVector<3>  ProjectWorldSpaceToScreenSpace(const mmlVector<3> &v) const;
 	bool          IsFront(const mmlVector<3> &a, const mmlVector<3> &b, const mmlVector<3> &c) const;
-	tiny3d::UInt  ClipNear(const retro3d::Vertex &a, const retro3d::Vertex &b, const retro3d::Vertex &c, retro3d::Vertex (&out)[4], bool &clipped) const;
+	tiny3d::UInt  ClipCode(const mmlVector<3> &v) const;
+	float         ClipDistance(const mmlVector<3> &v, tiny3d::UInt plane) const;
+	tiny3d::UInt  ClipNear(const retro3d::Vertex &a, const retro3d::Vertex &b, const retro3d::Vertex &c, retro3d::Vertex (&out)[RETRO3D_CLIP_VERTEX_MAX], bool &clipped) const;
 	void          ClearBuffers(tiny3d::URect rect);
 	tiny3d::UInt  DetermineMipLevel(const retro3d::Texture &mips, const retro3d::Vertex &ss_vert_a, const retro3d::Vertex &ss_vert_b, const retro3d::Vertex &ss_vert_c) const;
 	void          Render(tiny3d::URect rect);
@@ -122,6 +182,8 @@ private:
 	void          RenderDisplay(const tiny3d::URect &rect, const Render3DJob &job, tiny3d::Array< retro3d::Light > &lights);
 	void          RenderAABB(const tiny3d::URect &rect, const Render3DJob &job, tiny3d::Array< retro3d::Light > &lights);
 	void          RenderFrustum(const tiny3d::URect &rect, const Render3DJob &job, tiny3d::Array< retro3d::Light > &lights);
+	void          RenderSprites(const tiny3d::URect &rect, const Render3DJob &job);
+	void          ExpandSprites( void );
 	void          DepthRender(tiny3d::URect rect);
 	void          Print(tiny3d::URect rect);
 	void          ExecuteJobs(tiny3d::SInt thread_num, tiny3d::SInt dst_height_per_thread, tiny3d::SInt video_height_per_thread, bool update_video_out);
@@ -147,6 +209,7 @@ public:
 	void RenderDisplayModel(const retro3d::DisplayModel &model, const mmlMatrix<4, 4> &obj_to_world, LightMode light_mode, RenderMode render_mode = RenderMode_Polygons) override;
 	void RenderSpritePlane(const retro3d::Model &sprite_plane, const mmlMatrix<4,4> &obj_to_world, LightMode light_mode, RenderMode render_mode = RenderMode_Polygons) override;
 	void RenderSpritePlane(const retro3d::Model &sprite_plane, const mmlMatrix<4,4> *obj_to_world, LightMode light_mode, RenderMode render_mode = RenderMode_Polygons) override;
+	void RenderSprites(const SpriteBatch &batch, RenderMode render_mode = RenderMode_Polygons) override;
 	void RenderLight(const retro3d::Light &light) override;
 	void RenderAABB(const retro3d::AABB &aabb, const mmlMatrix<4,4> &obj_to_world, const mmlVector<3> &color = mmlVector<3>(0.0, 1.0, 0.0), bool world_axis_aligned = true) override;
 	void RenderAABB(const retro3d::AABB &aabb, const mmlMatrix<4,4> *obj_to_world, const mmlVector<3> &color = mmlVector<3>(0.0, 1.0, 0.0), bool world_axis_aligned = true) override;
@@ -174,6 +237,7 @@ public:
 	float GetVerticalFieldOfView( void ) const override;
 	void SetHorizontalFieldOfView(float hori_fov) override;
 	retro3d::Frustum GetViewFrustum( void ) const override;
+	FrameStats GetFrameStats( void ) const override;
 
 	void Debug_RenderTriangle(const retro3d::Vertex &a, const retro3d::Vertex &b, const retro3d::Vertex &c, const mmlMatrix<4,4> &obj_to_world, const mmlMatrix<4,4> &world_to_view, const retro3d::Texture *texture, LightMode light_mode) override;
 };
@@ -6,6 +6,14 @@
 #include "MiniLib/MTL/mtlStringMap.h"
 #include "../serial/retro_serialize.h"
 
+// NOTE: Define RETRO3D_THREAD_LOCAL_ASSETS to give every thread its own asset libraries, which lets several engines run concurrently on different threads without sharing assets.
+// Assets must then be loaded on the thread that runs the engine using them.
+#ifdef RETRO3D_THREAD_LOCAL_ASSETS
+	#define RETRO3D_ASSET_STORAGE thread_local
+#else
+	#define RETRO3D_ASSET_STORAGE
+#endif
+
 namespace retro3d
 {
 
@@ -99,11 +107,11 @@ template < typename type_t >
 class Asset : public retro3d::Serializeable
 {
 public:
-	static AssetLib<type_t> Library;
+	static RETRO3D_ASSET_STORAGE AssetLib<type_t> Library;
 };
 
 }
 
-template < typename type_t > retro3d::AssetLib<type_t> retro3d::Asset<type_t>::Library;
+template < typename type_t > RETRO3D_ASSET_STORAGE retro3d::AssetLib<type_t> retro3d::Asset<type_t>::Library;
 
 #endif // RETRO_ASSETS_H
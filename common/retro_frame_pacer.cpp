@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include "retro_frame_pacer.h"
+
+retro3d::FramePacer::FramePacer(uint32_t hz) :
+	m_period_ns(0), m_spin_ns(2000000), m_deadline_ns(0), m_sample_count(0), m_missed(0)
+{
+	SetFrequency(hz);
+}
+
+uint64_t retro3d::FramePacer::Now( void )
+{
+	return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void retro3d::FramePacer::SetFrequency(uint32_t hz)
+{
+	m_period_ns = hz > 0 ? 1000000000 / uint64_t(hz) : 0;
+}
+
+void retro3d::FramePacer::SetSpinBudget(uint32_t microseconds)
+{
+	m_spin_ns = uint64_t(microseconds) * 1000;
+}
+
+uint32_t retro3d::FramePacer::GetSpinBudget( void ) const
+{
+	return uint32_t(m_spin_ns / 1000);
+}
+
+void retro3d::FramePacer::Wait( void )
+{
+	uint64_t now = Now();
+	if (m_period_ns == 0 || m_deadline_ns == 0) {
+		m_deadline_ns = now + m_period_ns;
+		return;
+	}
+
+	if (now >= m_deadline_ns) {
+		++m_missed;
+		m_deadline_ns = now + m_period_ns;
+		return;
+	}
+
+	if (m_deadline_ns - now > m_spin_ns) {
+		std::this_thread::sleep_for(std::chrono::nanoseconds(m_deadline_ns - now - m_spin_ns));
+		now = Now();
+	}
+	while (now < m_deadline_ns) {
+		std::this_thread::yield();
+		now = Now();
+	}
+
+	// NOTE: Oversleeping past the spin budget is recorded as a deviation, but the next frame still starts at the deadline so that the rate does not drift.
+	m_samples[m_sample_count % RETRO3D_FRAME_PACER_SAMPLES] = now - m_deadline_ns;
+	++m_sample_count;
+	m_deadline_ns += m_period_ns;
+	if (m_deadline_ns <= now) {
+		m_deadline_ns = now + m_period_ns;
+	}
+}
+
+void retro3d::FramePacer::Reset( void )
+{
+	m_deadline_ns = Now() + m_period_ns;
+	m_sample_count = 0;
+	m_missed = 0;
+}
+
+retro3d::FramePacer::Stats retro3d::FramePacer::GetStats( void ) const
+{
+	Stats stats = { 0.0, 0.0, 0.0, 0, m_missed };
+	const uint32_t count = uint32_t(std::min(m_sample_count, uint64_t(RETRO3D_FRAME_PACER_SAMPLES)));
+	if (count == 0) { return stats; }
+
+	uint64_t samples[RETRO3D_FRAME_PACER_SAMPLES];
+	std::copy(m_samples, m_samples + count, samples);
+	std::sort(samples, samples + count);
+
+	uint64_t sum = 0;
+	for (uint32_t i = 0; i < count; ++i) {
+		sum += samples[i];
+	}
+	stats.mean_ms = double(sum) / count / 1000000.0;
+	stats.p99_ms  = double(samples[(count * 99) / 100]) / 1000000.0;
+	stats.max_ms  = double(samples[count - 1]) / 1000000.0;
+	stats.frames  = count;
+	return stats;
+}
@@ -0,0 +1,59 @@
+#ifndef RETRO_FRAME_PACER_H
+#define RETRO_FRAME_PACER_H
+
+#include <cstdint>
+
+#define RETRO3D_FRAME_PACER_SAMPLES 256 // Number of frames the statistics are computed over.
+
+namespace retro3d
+{
+
+// Holds frames to a target rate. Sleeps for the coarse part of the remaining frame time and spins for the last part, since sleeping alone oversleeps by up to several milliseconds on most platforms.
+class FramePacer
+{
+public:
+	// Deviation of the wake-up time from the end of the frame, over the most recent frames the pacer waited for.
+	struct Stats
+	{
+		double   mean_ms;
+		double   p99_ms;
+		double   max_ms;
+		uint32_t frames; // Number of frames the statistics are computed over.
+		uint64_t missed; // Total number of frames that ended after their deadline, and so were not waited for.
+	};
+
+private:
+	uint64_t m_period_ns;
+	uint64_t m_spin_ns;
+	uint64_t m_deadline_ns; // End of the current frame, or 0 before the first frame.
+	uint64_t m_samples[RETRO3D_FRAME_PACER_SAMPLES]; // Ring buffer of deviations in nanoseconds.
+	uint64_t m_sample_count; // Total number of samples recorded.
+	uint64_t m_missed;
+
+public:
+	// Construction.
+	explicit FramePacer(uint32_t hz = 0);
+
+	// Returns the current time in nanoseconds on a monotonic clock.
+	static uint64_t Now( void );
+
+	// Sets the target frame rate. 0 Hz never waits.
+	void SetFrequency(uint32_t hz);
+
+	// Sets the time before the end of a frame at which the pacer stops sleeping and starts spinning. Larger budgets are more precise but burn more CPU.
+	void SetSpinBudget(uint32_t microseconds);
+	uint32_t GetSpinBudget( void ) const;
+
+	// Waits until the end of the current frame and starts the next. Frames are spaced evenly, but a frame that ends late starts the next frame from the current time rather than trying to catch up.
+	void Wait( void );
+
+	// Starts a new frame at the current time and clears the statistics.
+	void Reset( void );
+
+	// Returns statistics of how precisely the pacer has woken up at the end of each frame.
+	Stats GetStats( void ) const;
+};
+
+}
+
+#endif // RETRO_FRAME_PACER_H
@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include "retro_profiler.h"
+
+namespace
+{
+
+// Returns the thread's buffer to the profiler when the thread exits.
+struct ThreadSlot
+{
+	retro3d::Profiler::ThreadBuffer *buffer = nullptr;
+
+	~ThreadSlot( void )
+	{
+		if (buffer != nullptr) {
+			retro3d::Profiler::Instance().ReleaseBuffer(buffer);
+		}
+	}
+};
+
+thread_local ThreadSlot t_slot;
+
+void WriteEscaped(std::ofstream &fout, const char *str)
+{
+	for (; *str != '\0'; ++str) {
+		if (*str == '"' || *str == '\\') {
+			fout << '\\';
+		}
+		fout << *str;
+	}
+}
+
+}
+
+retro3d::Profiler::Profiler( void ) :
+	m_frame(0), m_frame_buffer(nullptr), m_origin_ns(Now()), m_enabled(true)
+{}
+
+retro3d::Profiler::~Profiler( void )
+{
+	for (size_t i = 0; i < m_buffers.size(); ++i) {
+		delete m_buffers[i];
+	}
+}
+
+retro3d::Profiler &retro3d::Profiler::Instance( void )
+{
+	static retro3d::Profiler instance;
+	return instance;
+}
+
+uint64_t retro3d::Profiler::Now( void )
+{
+	return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+retro3d::Profiler::ThreadBuffer *retro3d::Profiler::AcquireBuffer( void )
+{
+	if (t_slot.buffer == nullptr) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_free_buffers.empty() == false) {
+			t_slot.buffer = m_free_buffers.back();
+			m_free_buffers.pop_back();
+		} else {
+			ThreadBuffer *buffer = new ThreadBuffer;
+			buffer->events.resize(RETRO3D_PROFILER_EVENTS_PER_THREAD);
+			buffer->count = 0;
+			buffer->id = uint32_t(m_buffers.size());
+			m_buffers.push_back(buffer);
+			t_slot.buffer = buffer;
+		}
+		t_slot.buffer->depth = 0;
+	}
+	return t_slot.buffer;
+}
+
+void retro3d::Profiler::ReleaseBuffer(retro3d::Profiler::ThreadBuffer *buffer)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_free_buffers.push_back(buffer);
+	if (m_frame_buffer == buffer) {
+		m_frame_buffer = nullptr;
+	}
+}
+
+void retro3d::Profiler::SetEnabled(bool enabled)
+{
+	m_enabled = enabled;
+}
+
+bool retro3d::Profiler::IsEnabled( void ) const
+{
+	return m_enabled;
+}
+
+void retro3d::Profiler::BeginFrame(uint64_t frame)
+{
+	m_frame.store(frame, std::memory_order_relaxed);
+	m_frame_buffer = AcquireBuffer();
+}
+
+void retro3d::Profiler::EndFrame( void )
+{
+	if (m_frame_buffer == nullptr) { return; }
+
+	for (size_t i = 0; i < m_summary.size(); ++i) {
+		m_summary[i].frame_ms = 0.0;
+	}
+
+	// NOTE: Walk backwards from the newest event until reaching events from an earlier frame, then visit them in the order they started.
+	const ThreadBuffer &buffer = *m_frame_buffer;
+	const uint64_t frame = m_frame.load(std::memory_order_relaxed);
+	const uint64_t size = buffer.events.size();
+	const uint64_t oldest = buffer.count > size ? buffer.count - size : 0;
+	m_frame_events.clear();
+	for (uint64_t i = buffer.count; i > oldest; --i) {
+		const Event &e = buffer.events[(i - 1) % size];
+		if (e.frame != frame) { break; }
+		if (e.depth <= RETRO3D_PROFILER_SUMMARY_DEPTH) {
+			m_frame_events.push_back(e);
+		}
+	}
+	std::sort(m_frame_events.begin(), m_frame_events.end(), [](const Event &a, const Event &b) { return a.start_ns < b.start_ns; });
+
+	for (size_t i = 0; i < m_frame_events.size(); ++i) {
+		const Event &e = m_frame_events[i];
+		size_t j = 0;
+		while (j < m_summary.size() && (m_summary[j].depth != e.depth || std::strcmp(m_summary[j].name, e.name) != 0)) {
+			++j;
+		}
+		if (j == m_summary.size()) {
+			m_summary.push_back(Summary{ e.name, 0.0, 0.0, e.depth });
+		}
+		m_summary[j].frame_ms += double(e.end_ns - e.start_ns) / 1000000.0;
+	}
+
+	for (size_t i = 0; i < m_summary.size(); ++i) {
+		m_summary[i].average_ms = m_summary[i].average_ms * 0.9 + m_summary[i].frame_ms * 0.1;
+	}
+}
+
+uint64_t retro3d::Profiler::GetFrame( void ) const
+{
+	return m_frame.load(std::memory_order_relaxed);
+}
+
+const std::vector<retro3d::Profiler::Summary> &retro3d::Profiler::GetSummary( void ) const
+{
+	return m_summary;
+}
+
+bool retro3d::Profiler::WriteChromeTrace(const std::string &file, uint32_t num_frames) const
+{
+	std::ofstream fout(file.c_str());
+	if (!fout.is_open()) {
+		std::cout << "[Profiler::WriteChromeTrace] Could not create/open trace file, ";
+		return false;
+	}
+
+	const uint64_t frame = m_frame.load(std::memory_order_relaxed);
+	const uint64_t first_frame = frame >= num_frames ? frame - num_frames + 1 : 0;
+
+	fout << "{\"traceEvents\":[" << std::endl;
+	fout << std::fixed << std::setprecision(3);
+	bool first = true;
+	for (size_t b = 0; b < m_buffers.size(); ++b) {
+		const ThreadBuffer &buffer = *m_buffers[b];
+		const uint64_t size = buffer.events.size();
+		const uint64_t oldest = buffer.count > size ? buffer.count - size : 0;
+		for (uint64_t i = oldest; i < buffer.count; ++i) {
+			const Event &e = buffer.events[i % size];
+			if (e.frame < first_frame || e.frame > frame) { continue; }
+			if (first == false) {
+				fout << "," << std::endl;
+			}
+			first = false;
+			fout << "{\"name\":\"";
+			WriteEscaped(fout, e.name);
+			fout << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer.id;
+			fout << ",\"ts\":" << double(e.start_ns - m_origin_ns) / 1000.0;
+			fout << ",\"dur\":" << double(e.end_ns - e.start_ns) / 1000.0;
+			fout << ",\"args\":{\"frame\":" << e.frame << "}}";
+		}
+	}
+	fout << std::endl << "]}" << std::endl;
+	return true;
+}
+
+retro3d::ProfileScope::ProfileScope(const char *name) :
+	m_buffer(nullptr), m_name(name), m_start_ns(0)
+{
+	retro3d::Profiler &profiler = retro3d::Profiler::Instance();
+	if (profiler.IsEnabled() == true) {
+		m_buffer = profiler.AcquireBuffer();
+		++m_buffer->depth;
+		m_start_ns = retro3d::Profiler::Now();
+	}
+}
+
+retro3d::ProfileScope::~ProfileScope( void )
+{
+	if (m_buffer != nullptr) {
+		const uint64_t end_ns = retro3d::Profiler::Now();
+		--m_buffer->depth;
+		retro3d::Profiler::Event &e = m_buffer->events[m_buffer->count % m_buffer->events.size()];
+		e.name     = m_name;
+		e.start_ns = m_start_ns;
+		e.end_ns   = end_ns;
+		e.frame    = retro3d::Profiler::Instance().GetFrame();
+		e.depth    = m_buffer->depth;
+		++m_buffer->count;
+	}
+}
@@ -0,0 +1,124 @@
+#ifndef RETRO_PROFILER_H
+#define RETRO_PROFILER_H
+
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define RETRO3D_PROFILER_EVENTS_PER_THREAD 16384 // Number of events each thread keeps before overwriting the oldest.
+#define RETRO3D_PROFILER_SUMMARY_DEPTH     2     // Deepest marker level (0 = outermost) included in the summary.
+
+namespace retro3d
+{
+
+// Collects timed, nested markers from all threads into per-thread ring buffers.
+// NOTE: Marker names are stored as pointers and must outlive the profiler (string literals or type names).
+class Profiler
+{
+public:
+	struct Event
+	{
+		const char *name;
+		uint64_t    start_ns;
+		uint64_t    end_ns;
+		uint64_t    frame;
+		uint32_t    depth;
+	};
+
+	struct Summary
+	{
+		const char *name;
+		double      average_ms; // Rolling average of the time spent in the marker per frame.
+		double      frame_ms;
+		uint32_t    depth;
+	};
+
+	// The events recorded by a single thread. Buffers of exited threads are reused by new threads.
+	struct ThreadBuffer
+	{
+		std::vector<Event> events;
+		uint64_t           count; // Total number of events written. events[count % size] is the next to be overwritten.
+		uint32_t           id;
+		uint32_t           depth;
+	};
+
+private:
+	std::vector<ThreadBuffer*> m_buffers;
+	std::vector<ThreadBuffer*> m_free_buffers;
+	std::vector<Summary>       m_summary;
+	std::vector<Event>         m_frame_events;
+	std::mutex                 m_mutex;
+	std::atomic<uint64_t>      m_frame;
+	ThreadBuffer              *m_frame_buffer; // Buffer of the thread that calls BeginFrame and EndFrame.
+	uint64_t                   m_origin_ns;
+	std::atomic<bool>          m_enabled;
+
+public:
+	// Construction.
+	Profiler( void );
+	~Profiler( void );
+
+	Profiler(const Profiler&) = delete;
+	Profiler &operator=(const Profiler&) = delete;
+
+	// Returns the process-wide profiler.
+	static Profiler &Instance( void );
+
+	// Returns the current time in nanoseconds on a monotonic clock.
+	static uint64_t Now( void );
+
+	// Returns the calling thread's buffer, acquiring one if the thread has none.
+	ThreadBuffer *AcquireBuffer( void );
+
+	// Returns a buffer to the profiler when its thread exits.
+	void ReleaseBuffer(ThreadBuffer *buffer);
+
+	// Enables or disables recording. Enabled by default.
+	void SetEnabled(bool enabled);
+	bool IsEnabled( void ) const;
+
+	// Marks the start and end of a frame on the calling thread. EndFrame updates the summary from the calling thread's markers.
+	void BeginFrame(uint64_t frame);
+	void EndFrame( void );
+
+	// Returns the frame passed to the last call to BeginFrame.
+	uint64_t GetFrame( void ) const;
+
+	// Returns the rolling per-frame summary of the frame thread's markers, in order of first appearance.
+	const std::vector<Summary> &GetSummary( void ) const;
+
+	// Writes the events of the last num_frames frames from all threads as Chrome trace_event JSON (chrome://tracing, Perfetto).
+	// NOTE: Reads other threads' buffers without locking, so only call this between frames while no other thread records markers.
+	bool WriteChromeTrace(const std::string &file, uint32_t num_frames) const;
+};
+
+// Records the time between construction and destruction as a marker with the given name.
+class ProfileScope
+{
+private:
+	retro3d::Profiler::ThreadBuffer *m_buffer;
+	const char                      *m_name;
+	uint64_t                         m_start_ns;
+
+public:
+	explicit ProfileScope(const char *name);
+	~ProfileScope( void );
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope &operator=(const ProfileScope&) = delete;
+};
+
+}
+
+#define RETRO3D_PROFILE_CONCAT_IMPL(a, b) a##b
+#define RETRO3D_PROFILE_CONCAT(a, b) RETRO3D_PROFILE_CONCAT_IMPL(a, b)
+
+#ifndef RETRO3D_PROFILER_DISABLED
+	#define RETRO3D_PROFILE_SCOPE(name) retro3d::ProfileScope RETRO3D_PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+#else
+	#define RETRO3D_PROFILE_SCOPE(name)
+#endif
+
+#endif // RETRO_PROFILER_H
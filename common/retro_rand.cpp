@@ -3,6 +3,16 @@
 retro3d::Random::Random(uint64_t seed, uint64_t inc) : m_rand(seed, inc)
 {}
 
+void retro3d::Random::WriteSnapshot(retro3d::SnapshotWriter &out) const
+{
+	out.Write(m_rand);
+}
+
+bool retro3d::Random::ReadSnapshot(retro3d::SnapshotReader &in)
+{
+	return in.Read(m_rand);
+}
+
 int32_t retro3d::Random::Range(int32_t min, int32_t max)
 {
 	return m_rand.GetInt(min, max);
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include "MiniLib/MML/mmlRandom.h"
 #include "MiniLib/MML/mmlVector.h"
+#include "../serial/retro_snapshot.h"
 
 namespace retro3d
 {
@@ -16,6 +17,10 @@ private:
 public:
 	Random(uint64_t seed, uint64_t inc = 1);
 
+	// Saves and restores the state of the generator so that a sequence can be replayed.
+	void WriteSnapshot(retro3d::SnapshotWriter &out) const;
+	bool ReadSnapshot(retro3d::SnapshotReader &in);
+
 	int32_t      Range(int32_t min, int32_t max);
 	float        Range(float min, float max);
 	float        Unit( void );
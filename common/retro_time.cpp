@@ -246,6 +246,12 @@ retro3d::Time retro3d::RealTimeTimer::GetScaledUpdateTime( void ) const
 	return m_accum_ticks;
 }
 
+void retro3d::RealTimeTimer::SetScaledTime(retro3d::Time time)
+{
+	UpdateTimer();
+	m_accum_ticks = time;
+}
+
 uint32_t retro3d::RealTimeTimer::GetTicks( void ) const
 {
 	return GetScaledTime().GetTotalSeconds();
@@ -226,6 +226,9 @@ public:
 	// Returns the time stamp since last update (UpdateTimer, SetTickRate, Start, Pause, Toggle, Reset, ResetTicks) scaled in relation to ticks.
 	retro3d::Time GetScaledUpdateTime( void ) const;
 
+	// Sets the time on the clock, scaled in relation to ticks, without changing whether the timer is ticking.
+	void SetScaledTime(retro3d::Time time);
+
 	// Returns the number of ticks that have elapsed. Corresponds to the whole part of GetTime().
 	uint32_t GetTicks( void ) const;
 
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <cmath>
+#include "retro_timer_wheel.h"
+
+void retro3d::TimerWheel::Link(uint32_t i)
+{
+	Entry &e = m_entries[i];
+	const uint64_t delta = e.deadline > m_now ? e.deadline - m_now : 0;
+	uint32_t level = 0;
+	while (level < LEVEL_COUNT - 1 && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+		++level;
+	}
+	e.bucket = level * SLOT_COUNT + uint32_t((e.deadline >> (SLOT_BITS * level)) & SLOT_MASK);
+	e.prev = NO_ENTRY;
+	e.next = m_buckets[e.bucket];
+	if (e.next != NO_ENTRY) {
+		m_entries[e.next].prev = i;
+	}
+	m_buckets[e.bucket] = i;
+}
+
+void retro3d::TimerWheel::Unlink(uint32_t i)
+{
+	Entry &e = m_entries[i];
+	if (e.prev != NO_ENTRY) {
+		m_entries[e.prev].next = e.next;
+	} else {
+		m_buckets[e.bucket] = e.next;
+	}
+	if (e.next != NO_ENTRY) {
+		m_entries[e.next].prev = e.prev;
+	}
+	e.bucket = NO_ENTRY;
+}
+
+void retro3d::TimerWheel::Release(uint32_t i)
+{
+	Entry &e = m_entries[i];
+	e.fn = nullptr;
+	if (++e.generation == 0) {
+		e.generation = 1;
+	}
+	m_free_entries.push_back(i);
+	--m_count;
+}
+
+void retro3d::TimerWheel::Cascade(uint32_t level)
+{
+	// NOTE: The slot is emptied before its entries are linked again, so entries can never be linked back into the slot being emptied.
+	const uint32_t bucket = level * SLOT_COUNT + uint32_t((m_now >> (SLOT_BITS * level)) & SLOT_MASK);
+	uint32_t i = m_buckets[bucket];
+	m_buckets[bucket] = NO_ENTRY;
+	while (i != NO_ENTRY) {
+		const uint32_t next = m_entries[i].next;
+		Link(i);
+		i = next;
+	}
+}
+
+uint32_t retro3d::TimerWheel::Find(retro3d::Handle<retro3d::TimerWheel> h) const
+{
+	const uint32_t i = h.GetIndex();
+	if (h.IsNull() == false && i < m_entries.size() && m_entries[i].generation == h.GetGeneration() && m_entries[i].bucket != NO_ENTRY) {
+		return i;
+	}
+	return NO_ENTRY;
+}
+
+retro3d::TimerWheel::TimerWheel( void ) : m_entries(), m_free_entries(), m_expired(), m_now(0), m_count(0)
+{
+	for (uint32_t i = 0; i < LEVEL_COUNT * SLOT_COUNT; ++i) {
+		m_buckets[i] = NO_ENTRY;
+	}
+}
+
+retro3d::Handle<retro3d::TimerWheel> retro3d::TimerWheel::Schedule(retro3d::Time delay, const retro3d::TimerWheel::Callback &fn)
+{
+	uint32_t i;
+	if (m_free_entries.empty() == false) {
+		i = m_free_entries.back();
+		m_free_entries.pop_back();
+	} else {
+		i = uint32_t(m_entries.size());
+		m_entries.push_back(Entry{ nullptr, 0, NO_ENTRY, NO_ENTRY, NO_ENTRY, 1 });
+	}
+	Entry &e = m_entries[i];
+	e.fn = fn;
+	e.deadline = m_now + std::max(uint64_t(std::ceil(delay.GetFloatSeconds() * 1000.0)), uint64_t(1)); // NOTE: Never in the current slot, which has already been visited.
+	Link(i);
+	++m_count;
+	return retro3d::Handle<retro3d::TimerWheel>(i, e.generation);
+}
+
+bool retro3d::TimerWheel::Cancel(retro3d::Handle<retro3d::TimerWheel> h)
+{
+	const uint32_t i = Find(h);
+	if (i == NO_ENTRY) { return false; }
+	if (m_entries[i].bucket != EXPIRED) {
+		Unlink(i);
+	}
+	m_entries[i].bucket = NO_ENTRY;
+	Release(i);
+	return true;
+}
+
+bool retro3d::TimerWheel::IsScheduled(retro3d::Handle<retro3d::TimerWheel> h) const
+{
+	return Find(h) != NO_ENTRY;
+}
+
+void retro3d::TimerWheel::Advance(retro3d::Time now)
+{
+	const uint64_t target = now.GetTotalMS();
+	if (m_count == 0) {
+		m_now = std::max(m_now, target);
+		return;
+	}
+
+	m_expired.clear();
+	while (m_now < target) {
+		++m_now;
+		for (uint32_t level = LEVEL_COUNT - 1; level > 0; --level) {
+			if ((m_now & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) == 0) {
+				Cascade(level);
+			}
+		}
+		const uint32_t bucket = uint32_t(m_now & SLOT_MASK);
+		for (uint32_t i = m_buckets[bucket]; i != NO_ENTRY;) {
+			const uint32_t next = m_entries[i].next;
+			m_entries[i].bucket = EXPIRED;
+			m_expired.push_back(retro3d::Handle<retro3d::TimerWheel>(i, m_entries[i].generation));
+			i = next;
+		}
+		m_buckets[bucket] = NO_ENTRY;
+	}
+
+	// NOTE: Callbacks are called after the clock has been advanced so that they see a consistent wheel. A callback may cancel a later expired callback, which is then skipped.
+	for (size_t j = 0; j < m_expired.size(); ++j) {
+		const uint32_t i = Find(m_expired[j]);
+		if (i == NO_ENTRY) { continue; }
+		Callback fn;
+		fn.swap(m_entries[i].fn);
+		m_entries[i].bucket = NO_ENTRY;
+		Release(i);
+		fn();
+	}
+	m_expired.clear();
+}
+
+void retro3d::TimerWheel::Reset(retro3d::Time now)
+{
+	for (uint32_t i = 0; i < m_entries.size(); ++i) {
+		if (m_entries[i].bucket != NO_ENTRY) {
+			if (m_entries[i].bucket != EXPIRED) {
+				Unlink(i);
+			}
+			m_entries[i].bucket = NO_ENTRY;
+			Release(i);
+		}
+	}
+	m_now = now.GetTotalMS();
+}
+
+retro3d::Time retro3d::TimerWheel::GetTime( void ) const
+{
+	return retro3d::Time(uint32_t(m_now));
+}
+
+uint32_t retro3d::TimerWheel::GetCount( void ) const
+{
+	return m_count;
+}
@@ -0,0 +1,90 @@
+#ifndef RETRO_TIMER_WHEEL_H
+#define RETRO_TIMER_WHEEL_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "retro_time.h"
+#include "../ecs/retro_handle.h"
+
+namespace retro3d
+{
+
+// Schedules callbacks on a clock that is advanced manually. Scheduling and cancelling is O(1), and advancing is proportional to the number of expired callbacks plus the elapsed number of milliseconds.
+// NOTE: Callbacks are kept in a hierarchy of wheels of 256 slots each. The first wheel has 1 ms slots, and each following wheel has slots that span a full turn of the previous wheel. Callbacks are moved to a finer wheel as their time approaches.
+class TimerWheel
+{
+public:
+	typedef std::function<void(void)> Callback;
+
+private:
+	enum
+	{
+		SLOT_BITS = 8,
+		SLOT_COUNT = 1 << SLOT_BITS,
+		SLOT_MASK = SLOT_COUNT - 1,
+		LEVEL_COUNT = 4,
+		NO_ENTRY = 0xffffffff,
+		EXPIRED = 0xfffffffe // Bucket of entries that are due but not yet called.
+	};
+
+	struct Entry
+	{
+		Callback fn;
+		uint64_t deadline; // In milliseconds.
+		uint32_t prev;
+		uint32_t next;
+		uint32_t bucket; // NO_ENTRY when not scheduled, EXPIRED when due.
+		uint32_t generation;
+	};
+
+private:
+	std::vector<Entry>                         m_entries;
+	std::vector<uint32_t>                      m_free_entries;
+	std::vector< retro3d::Handle<TimerWheel> > m_expired;
+	uint32_t                                   m_buckets[LEVEL_COUNT * SLOT_COUNT]; // First entry in each slot of each wheel.
+	uint64_t                                   m_now; // In milliseconds.
+	uint32_t                                   m_count;
+
+private:
+	void Link(uint32_t i);
+	void Unlink(uint32_t i);
+	void Release(uint32_t i);
+	void Cascade(uint32_t level);
+	uint32_t Find(retro3d::Handle<TimerWheel> h) const;
+
+public:
+	// Construction.
+	TimerWheel( void );
+
+	TimerWheel(const TimerWheel&) = delete;
+	TimerWheel &operator=(const TimerWheel&) = delete;
+
+	// Calls fn once the clock has advanced by at least the given delay. A delay of 0 calls fn the next time the clock advances.
+	retro3d::Handle<TimerWheel> Schedule(retro3d::Time delay, const Callback &fn);
+
+	// Removes a scheduled callback. Returns false if the callback has already been called or cancelled.
+	bool Cancel(retro3d::Handle<TimerWheel> h);
+
+	// Determines if the callback is still waiting to be called.
+	bool IsScheduled(retro3d::Handle<TimerWheel> h) const;
+
+	// Moves the clock forward to the given time and calls all callbacks that are due, in order of expiry per millisecond.
+	// NOTE: Callbacks may schedule and cancel other callbacks. Callbacks scheduled from within a callback are called no earlier than the next advance.
+	void Advance(retro3d::Time now);
+
+	// Removes all callbacks without calling them and sets the clock.
+	void Reset(retro3d::Time now);
+
+	// Returns the time the clock was last advanced to.
+	retro3d::Time GetTime( void ) const;
+
+	// Returns the number of scheduled callbacks.
+	uint32_t GetCount( void ) const;
+};
+
+typedef retro3d::Handle<retro3d::TimerWheel> TimerHandle;
+
+}
+
+#endif // RETRO_TIMER_WHEEL_H
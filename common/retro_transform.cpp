@@ -1,10 +1,58 @@
 #include "retro_transform.h"
 
+// NOTE: Lock-free, so concurrent readers never wait for each other, at the cost of occasionally computing the same value more than once.
+template < typename value_t, typename compute_t >
+value_t retro3d::Transform::ReadCache(std::atomic<uint32_t> &state, value_t &cache, compute_t compute)
+{
+	if (state.load(std::memory_order_acquire) == Cache_Valid) {
+		return cache;
+	}
+	const value_t value = compute();
+	uint32_t expected = Cache_Stale;
+	if (state.compare_exchange_strong(expected, Cache_Writing, std::memory_order_acquire) == true) {
+		cache = value;
+		state.store(Cache_Valid, std::memory_order_release);
+	}
+	return value;
+}
+
 bool retro3d::Transform::SelfRef(const retro3d::Transform *t) const
 {
 	return t == this || (m_parent.IsNull() == false ? m_parent->SelfRef(t) : false);
 }
 
+void retro3d::Transform::AttachToParent( void )
+{
+	if (m_parent.IsNull() == false) {
+		m_parent->m_children.push_back(this);
+	}
+}
+
+void retro3d::Transform::DetachFromParent( void )
+{
+	if (m_parent.IsNull() == false) {
+		std::vector<retro3d::Transform*> &siblings = m_parent->m_children;
+		for (size_t i = 0; i < siblings.size(); ++i) {
+			if (siblings[i] == this) {
+				siblings[i] = siblings.back();
+				siblings.pop_back();
+				break;
+			}
+		}
+	}
+}
+
+void retro3d::Transform::InvalidateWorld( void ) const
+{
+	if (m_world_state.load(std::memory_order_relaxed) != Cache_Stale) {
+		m_world_state.store(Cache_Stale, std::memory_order_relaxed);
+		++m_world_version;
+		for (size_t i = 0; i < m_children.size(); ++i) {
+			m_children[i]->InvalidateWorld();
+		}
+	}
+}
+
 mmlVector<3> retro3d::Transform::GetWorldRight( void )
 {
 	mmlVector<3> x;
@@ -52,7 +100,7 @@ std::string retro3d::Transform::GetWorldAxisName(int axis_index)
 	return "Error";
 }
 
-retro3d::Transform::Transform(uint32_t space_from, uint32_t space_to) : mmlMatrix<4,4>(mmlMatrix<4,4>::Identity()), m_parent(), m_inv(mmlMatrix<4,4>::Identity()), m_rot(mmlMatrix<3,3>::Identity()), m_space_from(space_from), m_space_to(space_to), m_inv_updated(true), m_rot_updated(true)
+retro3d::Transform::Transform(uint32_t space_from, uint32_t space_to) : mmlMatrix<4,4>(mmlMatrix<4,4>::Identity()), m_parent(), m_children(), m_inv(mmlMatrix<4,4>::Identity()), m_rot(mmlMatrix<3,3>::Identity()), m_world(mmlMatrix<4,4>::Identity()), m_world_version(0), m_space_from(space_from), m_space_to(space_to), m_inv_state(Cache_Valid), m_rot_state(Cache_Valid), m_world_state(Cache_Valid)
 {}
 
 retro3d::Transform::Transform(const mmlMatrix<3,3> &basis, const mmlVector<3> &position) : Transform()
@@ -60,9 +108,32 @@ retro3d::Transform::Transform(const mmlMatrix<3,3> &basis, const mmlVector<3> &p
 	SetTransform(basis, position);
 }
 
-retro3d::Transform::Transform(const mmlMatrix<4,4> &transform) : mmlMatrix<4,4>(transform), m_parent(), m_inv(mmlMatrix<4,4>::Identity()), m_rot(mmlMatrix<3,3>::Identity()), m_space_from(Space_Object), m_space_to(Space_World), m_inv_updated(false), m_rot_updated(false)
+retro3d::Transform::Transform(const mmlMatrix<4,4> &transform) : mmlMatrix<4,4>(transform), m_parent(), m_children(), m_inv(mmlMatrix<4,4>::Identity()), m_rot(mmlMatrix<3,3>::Identity()), m_world(mmlMatrix<4,4>::Identity()), m_world_version(0), m_space_from(Space_Object), m_space_to(Space_World), m_inv_state(Cache_Stale), m_rot_state(Cache_Stale), m_world_state(Cache_Stale)
 {}
 
+retro3d::Transform::Transform(const retro3d::Transform &transform) : mmlMatrix<4,4>(transform), m_parent(transform.m_parent), m_children(), m_inv(transform.m_inv), m_rot(transform.m_rot), m_world(transform.m_world), m_world_version(0), m_space_from(transform.m_space_from), m_space_to(transform.m_space_to), m_inv_state(transform.m_inv_state.load() == Cache_Valid ? Cache_Valid : Cache_Stale), m_rot_state(transform.m_rot_state.load() == Cache_Valid ? Cache_Valid : Cache_Stale), m_world_state(transform.m_world_state.load() == Cache_Valid ? Cache_Valid : Cache_Stale)
+{
+	// NOTE: The copy shares the parent, but not the children, of the original.
+	AttachToParent();
+}
+
+retro3d::Transform::~Transform( void )
+{
+	// NOTE: Children keep their parent alive, so there can be no children left to detach at this point.
+	DetachFromParent();
+}
+
+retro3d::Transform &retro3d::Transform::operator=(const retro3d::Transform &transform)
+{
+	if (this != &transform) {
+		SetParent(transform.m_parent);
+		SetTransform(transform);
+		m_space_from = transform.m_space_from;
+		m_space_to = transform.m_space_to;
+	}
+	return *this;
+}
+
 retro3d::Transform &retro3d::Transform::operator=(const mmlMatrix<4,4> &transform)
 {
 	SetTransform(transform);
@@ -72,7 +143,12 @@ retro3d::Transform &retro3d::Transform::operator=(const mmlMatrix<4,4> &transfor
 void retro3d::Transform::SetParent(mtlShared<const retro3d::Transform> parent)
 {
 	if (parent.IsNull() == false && SelfRef(parent.GetShared()) == false) {
-		m_parent = parent;
+		if (parent.GetShared() != m_parent.GetShared()) {
+			DetachFromParent();
+			m_parent = parent;
+			AttachToParent();
+			InvalidateWorld();
+		}
 	} else {
 		OrphanTransform();
 	}
@@ -80,7 +156,9 @@ void retro3d::Transform::SetParent(mtlShared<const retro3d::Transform> parent)
 
 void retro3d::Transform::OrphanTransform( void )
 {
+	DetachFromParent();
 	m_parent.Delete();
+	InvalidateWorld();
 }
 
 void retro3d::Transform::SetTransform(const mmlMatrix<3,3> &basis, const mmlVector<3> &position)
@@ -95,8 +173,9 @@ void retro3d::Transform::SetTransform(const mmlMatrix<4,4> &transform)
 			(*this)[i][j] = transform[i][j];
 		}
 	}
-	m_rot_updated = false;
-	m_inv_updated = false;
+	m_rot_state.store(Cache_Stale, std::memory_order_relaxed);
+	m_inv_state.store(Cache_Stale, std::memory_order_relaxed);
+	InvalidateWorld();
 }
 
 void retro3d::Transform::SetRotation(const mmlMatrix<3,3> &rotation)
@@ -108,8 +187,9 @@ void retro3d::Transform::SetRotation(const mmlMatrix<3,3> &rotation)
 			(*this)[i][j] = row[j];
 		}
 	}
-	m_inv_updated = false;
-	m_rot_updated = false;
+	m_inv_state.store(Cache_Stale, std::memory_order_relaxed);
+	m_rot_state.store(Cache_Stale, std::memory_order_relaxed);
+	InvalidateWorld();
 }
 
 void retro3d::Transform::SetBasis(const mmlMatrix<3,3> &basis)
@@ -119,8 +199,9 @@ void retro3d::Transform::SetBasis(const mmlMatrix<3,3> &basis)
 			(*this)[i][j] = basis[i][j];
 		}
 	}
-	m_inv_updated = false;
-	m_rot_updated = false;
+	m_inv_state.store(Cache_Stale, std::memory_order_relaxed);
+	m_rot_state.store(Cache_Stale, std::memory_order_relaxed);
+	InvalidateWorld();
 }
 
 void retro3d::Transform::SetPosition(const mmlVector<3> &position)
@@ -128,7 +209,8 @@ void retro3d::Transform::SetPosition(const mmlVector<3> &position)
 	for (int i = 0; i < 3; ++i) {
 		(*this)[i][3] = position[i];
 	}
-	m_inv_updated = false;
+	m_inv_state.store(Cache_Stale, std::memory_order_relaxed);
+	InvalidateWorld();
 	// does not affect rotation
 }
 
@@ -140,7 +222,8 @@ void retro3d::Transform::NormalizeScale( void )
 			(*this)[i][j] = rot[i][j];
 		}
 	}
-	m_inv_updated = false;
+	m_inv_state.store(Cache_Stale, std::memory_order_relaxed);
+	InvalidateWorld();
 	// does not affect rotation
 }
 
@@ -152,7 +235,8 @@ void retro3d::Transform::SetScale(const mmlVector<3> &xyz)
 			(*this)[i][j] *= xyz[i];
 		}
 	}
-	m_inv_updated = false;
+	m_inv_state.store(Cache_Stale, std::memory_order_relaxed);
+	InvalidateWorld();
 	// does not affect rotation
 }
 
@@ -168,23 +252,19 @@ mmlMatrix<4,4> retro3d::Transform::GetMatrix( void ) const
 
 mmlMatrix<4,4> retro3d::Transform::GetInvMatrix( void ) const
 {
-	if (m_inv_updated == false) {
-		m_inv = mmlInv(*this);
-		m_inv_updated = true;
-	}
-	return m_inv;
+	return ReadCache(m_inv_state, m_inv, [this]( void ) { return mmlInv(*this); });
 }
 
 mmlMatrix<3,3> retro3d::Transform::GetRotation( void ) const
 {
-	if (m_rot_updated == false) {
+	return ReadCache(m_rot_state, m_rot, [this]( void ) {
 		const mmlVector<3> S = GetScale();
+		mmlMatrix<3,3> rot;
 		for (int i = 0; i < 3; ++i) {
-			m_rot[i] = mmlVector<3>((*this)[i]) / S[i];
+			rot[i] = mmlVector<3>((*this)[i]) / S[i];
 		}
-		m_rot_updated = true;
-	}
-	return m_rot;
+		return rot;
+	});
 }
 
 mmlMatrix<3,3> retro3d::Transform::GetBasis( void ) const
@@ -226,17 +306,22 @@ retro3d::Transform retro3d::Transform::GetInvTransform( void ) const
 	Transform t;
 	t = GetInvMatrix();
 	t.m_inv = *this;
-	t.m_inv_updated = true;
-	t.m_rot_updated = false;
+	t.m_inv_state.store(Cache_Valid, std::memory_order_relaxed);
+	t.m_rot_state.store(Cache_Stale, std::memory_order_relaxed);
 	return t;
 }
 
 mmlMatrix<4,4> retro3d::Transform::GetFinalMatrix( void ) const
 {
-	if (m_parent.IsNull() == true) {
-		return *this;
-	}
-	return m_parent->GetFinalMatrix() * (*this);
+	// NOTE: Parents are brought up to date before their children since the parent's final matrix is requested first.
+	return ReadCache(m_world_state, m_world, [this]( void ) {
+		return m_parent.IsNull() == true ? mmlMatrix<4,4>(*this) : m_parent->GetFinalMatrix() * (*this);
+	});
+}
+
+uint64_t retro3d::Transform::GetFinalMatrixVersion( void ) const
+{
+	return m_world_version;
 }
 
 mmlVector<3> retro3d::Transform::TransformPoint(const mmlVector<3> &point) const
@@ -1,7 +1,9 @@
 #ifndef RETRO_TRANSFORM_H
 #define RETRO_TRANSFORM_H
 
+#include <atomic>
 #include <string>
+#include <vector>
 #include "MiniLib/MML/mmlVector.h"
 #include "MiniLib/MML/mmlMatrix.h"
 #include "MiniLib/MTL/mtlPointer.h"
@@ -9,6 +11,9 @@
 namespace retro3d
 {
 
+// NOTE: The cached matrices may be read from several threads at once, but not while the transform, or one of its parents, is being written to.
+// NOTE: Copying, assigning, reparenting or destroying a transform that has a parent writes to the parent's list of children and reference count, so it counts as a write to the parent and must not happen while other threads read the parent or its descendants. Concurrent readers that need a copy of a parented transform must synchronize among themselves.
+// NOTE: tools/transform_stress.cpp exercises concurrent reads and can be built with ThreadSanitizer.
 class Transform : public mmlMatrix<4,4>
 {
 public:
@@ -22,16 +27,39 @@ public:
 	};
 
 private:
-	mtlShared<const retro3d::Transform> m_parent;
-	mutable mmlMatrix<4,4>              m_inv;
-	mutable mmlMatrix<3,3>              m_rot;
-	uint32_t                            m_space_from;
-	uint32_t                            m_space_to; // Spaces can be used to determine if matrix operations are formally correct
-	mutable bool                        m_inv_updated;
-	mutable bool                        m_rot_updated;
+	// The state of a lazily computed matrix.
+	enum CacheState
+	{
+		Cache_Stale,
+		Cache_Writing, // A reader is storing a newly computed matrix. Other readers compute the matrix themselves in the meantime.
+		Cache_Valid
+	};
+
+private:
+	mtlShared<const retro3d::Transform>        m_parent;
+	mutable std::vector<retro3d::Transform*>   m_children; // Transforms that have this transform as parent. Kept so that changes can invalidate their world matrices.
+	mutable mmlMatrix<4,4>                     m_inv;
+	mutable mmlMatrix<3,3>                     m_rot;
+	mutable mmlMatrix<4,4>                     m_world; // Cached product of all parent matrices and this matrix.
+	mutable uint64_t                           m_world_version;
+	uint32_t                                   m_space_from;
+	uint32_t                                   m_space_to; // Spaces can be used to determine if matrix operations are formally correct
+	mutable std::atomic<uint32_t>              m_inv_state;
+	mutable std::atomic<uint32_t>              m_rot_state;
+	mutable std::atomic<uint32_t>              m_world_state;
 
 private:
+	// Returns the cached value if it is valid. Otherwise computes the value and lets the first reader to get there store it in the cache.
+	template < typename value_t, typename compute_t >
+	static value_t ReadCache(std::atomic<uint32_t> &state, value_t &cache, compute_t compute);
+
 	bool SelfRef(const retro3d::Transform *t) const;
+	void AttachToParent( void );
+	void DetachFromParent( void );
+
+	// Marks the world matrix of this transform and all its descendants as out of date.
+	// NOTE: A transform with an out of date world matrix never has descendants with up to date world matrices, so propagation stops at transforms that are already out of date.
+	void InvalidateWorld( void ) const;
 
 public:
 	static mmlVector<3> GetWorldRight( void );
@@ -44,7 +72,9 @@ public:
 	Transform(uint32_t space_from = Space_Object, uint32_t space_to = Space_World);
 	Transform(const mmlMatrix<3,3> &basis, const mmlVector<3> &position);
 	Transform(const mmlMatrix<4,4> &transform);
-	Transform &operator=(const retro3d::Transform &transform) = default;
+	Transform(const retro3d::Transform &transform);
+	~Transform( void );
+	Transform &operator=(const retro3d::Transform &transform);
 	Transform &operator=(const mmlMatrix<4,4> &transform);
 
 	void SetParent(mtlShared<const retro3d::Transform> parent);
@@ -72,8 +102,12 @@ public:
 	mmlVector<3>       GetForward( void ) const;
 	retro3d::Transform GetInvTransform( void ) const;
 
+	// Returns the product of all parent matrices and this matrix. The result is cached until this transform or one of its parents changes.
 	mmlMatrix<4,4> GetFinalMatrix( void ) const;
 
+	// Returns a number that changes every time the final matrix is invalidated. Can be used by users to cache values derived from the final matrix.
+	uint64_t GetFinalMatrixVersion( void ) const;
+
 	mmlVector<3> TransformPoint(const mmlVector<3> &point) const;
 	mmlVector<3> TransformVector(const mmlVector<3> &vec) const;
 	mmlVector<3> TransformNormal(const mmlVector<3> &normal) const;
@@ -0,0 +1,112 @@
+#include "retro_workers.h"
+
+static thread_local bool t_in_task = false;
+
+void retro3d::WorkerPool::WorkerLoop(uint64_t start_generation)
+{
+	// NOTE: The generation at the time the thread was started is passed in, since Execute may begin a batch before the thread first takes the lock.
+	uint64_t seen_generation = start_generation;
+	std::unique_lock<std::mutex> lock(m_mutex);
+	for (;;) {
+		m_wake.wait(lock, [&]{ return m_quit == true || m_generation != seen_generation; });
+		if (m_quit == true) { return; }
+		seen_generation = m_generation;
+		lock.unlock();
+		RunTasks();
+		lock.lock();
+		// NOTE: Execute does not return before every worker has acknowledged the batch, so no worker can observe the next batch half-written.
+		if (++m_workers_done == m_thread_count) {
+			m_done.notify_all();
+		}
+	}
+}
+
+void retro3d::WorkerPool::RunTasks( void )
+{
+	const bool was_in_task = t_in_task;
+	t_in_task = true;
+	for (uint32_t i = m_next_task.fetch_add(1); i < m_task_count; i = m_next_task.fetch_add(1)) {
+		(*m_task)(i);
+	}
+	t_in_task = was_in_task;
+}
+
+void retro3d::WorkerPool::StartThreads( void )
+{
+	// NOTE: Workers read the shared state under the lock, so the thread list is built while holding it.
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_quit = false;
+	for (uint32_t i = 0; i < m_thread_count; ++i) {
+		m_threads.push_back(std::thread(&retro3d::WorkerPool::WorkerLoop, this, m_generation));
+	}
+}
+
+void retro3d::WorkerPool::StopThreads( void )
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_quit = true;
+	}
+	m_wake.notify_all();
+	for (size_t i = 0; i < m_threads.size(); ++i) {
+		m_threads[i].join();
+	}
+	m_threads.clear();
+}
+
+retro3d::WorkerPool::WorkerPool( void ) :
+	m_task(nullptr), m_next_task(0), m_task_count(0), m_workers_done(0), m_generation(0), m_thread_count(0), m_quit(false)
+{}
+
+retro3d::WorkerPool::~WorkerPool( void )
+{
+	StopThreads();
+}
+
+void retro3d::WorkerPool::SetThreadCount(uint32_t thread_count)
+{
+	if (thread_count != m_thread_count) {
+		StopThreads();
+		m_thread_count = thread_count;
+	}
+}
+
+uint32_t retro3d::WorkerPool::GetThreadCount( void ) const
+{
+	return m_thread_count;
+}
+
+void retro3d::WorkerPool::Execute(uint32_t task_count, const std::function<void(uint32_t)> &task)
+{
+	if (task_count == 0) { return; }
+
+	if (task_count == 1 || m_thread_count == 0 || t_in_task == true) {
+		const bool was_in_task = t_in_task;
+		t_in_task = true;
+		for (uint32_t i = 0; i < task_count; ++i) {
+			task(i);
+		}
+		t_in_task = was_in_task;
+		return;
+	}
+
+	if (m_threads.size() != m_thread_count) {
+		StartThreads();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_task         = &task;
+		m_task_count   = task_count;
+		m_workers_done = 0;
+		m_next_task.store(0);
+		++m_generation;
+	}
+	m_wake.notify_all();
+
+	RunTasks();
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_done.wait(lock, [&]{ return m_workers_done == m_thread_count; });
+	m_task = nullptr;
+}
@@ -0,0 +1,56 @@
+#ifndef RETRO_WORKERS_H
+#define RETRO_WORKERS_H
+
+#include <cstdint>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace retro3d
+{
+
+// A fixed set of worker threads that execute batches of indexed tasks. The calling thread participates in the work.
+class WorkerPool
+{
+private:
+	std::vector<std::thread>               m_threads;
+	std::mutex                             m_mutex;
+	std::condition_variable                m_wake;
+	std::condition_variable                m_done;
+	const std::function<void(uint32_t)>   *m_task;
+	std::atomic<uint32_t>                  m_next_task;
+	uint32_t                               m_task_count;
+	uint32_t                               m_workers_done;
+	uint64_t                               m_generation;
+	uint32_t                               m_thread_count;
+	bool                                   m_quit;
+
+private:
+	void WorkerLoop(uint64_t start_generation);
+	void RunTasks( void );
+	void StartThreads( void );
+	void StopThreads( void );
+
+public:
+	// Construction.
+	WorkerPool( void );
+	~WorkerPool( void );
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool &operator=(const WorkerPool&) = delete;
+
+	// Sets the number of worker threads (excluding the calling thread). Threads are started lazily on the next call to Execute.
+	void     SetThreadCount(uint32_t thread_count);
+	uint32_t GetThreadCount( void ) const;
+
+	// Calls task(i) for every i from 0 up to, but not including, task_count, and returns when all tasks are finished.
+	// NOTE: Calls from within a task are executed serially on the calling thread.
+	void Execute(uint32_t task_count, const std::function<void(uint32_t)> &task);
+};
+
+}
+
+#endif // RETRO_WORKERS_H
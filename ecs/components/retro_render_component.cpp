@@ -80,9 +80,7 @@ void retro3d::RenderComponent::CreateAnimation(const mtlChars &animation_name, u
 {
 	Animation *a = m_animations.CreateEntry(animation_name);
 
-	mtlShared<retro3d::Model> default_copy;
-	default_copy.New();
-	*default_copy.GetShared() = *retro3d::Engine::DefaultModel().GetShared();
+	mtlShared<retro3d::Model> default_copy = retro3d::Engine::DefaultModel();
 
 	a->frames.Create(mmlMax(1, int(frame_count)));
 	for (int i = 0; i < a->frames.GetSize(); ++i) {
@@ -100,9 +98,7 @@ void retro3d::RenderComponent::CreateAnimation(const mtlChars &animation_name, u
 void retro3d::RenderComponent::CreateAnimation(uint32_t frame_count)
 {
 	if (m_current_animation != nullptr) {
-		mtlShared<retro3d::Model> default_copy;
-		default_copy.New();
-		*default_copy.GetShared() = *retro3d::Engine::DefaultModel().GetShared();
+		mtlShared<retro3d::Model> default_copy = retro3d::Engine::DefaultModel();
 
 		m_current_animation->frames.Create(mmlMax(1, int(frame_count)));
 		for (int i = 0; i < m_current_animation->frames.GetSize(); ++i) {
@@ -155,7 +151,7 @@ uint32_t retro3d::RenderComponent::GetAnimationFrameCount( void ) const
 mmlMatrix<4,4> retro3d::RenderComponent::GetTransformMatrix( void ) const
 {
 	const retro3d::TransformComponent *t = GetObject()->GetComponent<retro3d::TransformComponent>();
-	return t != nullptr ? t->GetTransform()->GetFinalMatrix() : mmlMatrix<4,4>::Identity();
+	return t != nullptr ? t->GetInterpolatedMatrix(GetEngine()->GetInterpolationAlpha()) : mmlMatrix<4,4>::Identity();
 }
 
 retro3d::RenderDevice::LightMode retro3d::RenderComponent::GetLightMode( void ) const
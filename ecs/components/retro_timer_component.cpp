@@ -1,15 +1,46 @@
 #include "retro_timer_component.h"
+#include "../../serial/retro_snapshot.h"
 
 namespace retro3d { retro_register_component(TimerComponent) }
 
-void retro3d::TimerComponent::OnSpawn( void )
+void retro3d::TimerComponent::Schedule( void )
 {
-	m_timer = this->GetObject()->CreateGameTimer();
+	Unschedule();
+	if (m_is_spawned == false || m_timer.IsTicking() == false) { return; }
+
+	// NOTE: Game timers are children of the entity game timer, so they run at the entity time scale relative to the engine game clock.
+	const double ticks_left = m_timer.GetTicks() > 0 ? 0.0 : 1.0 - m_timer.GetTickProgress();
+	const double time_scale = m_timer_type == retro3d::TIMER_GAME ? GetObject()->GetTimeScale() : 1.0;
+	const double delay = time_scale > 0.0 ? ticks_left * m_timer.GetTimePerTick().GetFloatSeconds() / time_scale : m_timer.GetTimePerTick().GetFloatSeconds();
+	m_wake = GetEngine()->GetTimerWheel(m_timer_type)->Schedule(retro3d::Time::FloatSeconds(delay), [this]( void ) { Wake(); });
+}
+
+void retro3d::TimerComponent::Unschedule( void )
+{
+	if (m_wake.IsNull() == false) {
+		GetEngine()->GetTimerWheel(m_timer_type)->Cancel(m_wake);
+		m_wake = retro3d::TimerHandle();
+	}
 }
 
-void retro3d::TimerComponent::OnUpdate( void )
+void retro3d::TimerComponent::Wake( void )
 {
+	m_wake = retro3d::TimerHandle();
+
+	if (IsDestroyed() == true) { return; }
+
+	// NOTE: Inactive timers are not updated, but real and simulation timers keep accumulating ticks, so check back one tick later.
+	if (IsActive() == false) {
+		m_wake = GetEngine()->GetTimerWheel(m_timer_type)->Schedule(m_timer.GetTimePerTick(), [this]( void ) { Wake(); });
+		return;
+	}
+
 	const uint32_t ticks = m_timer.GetTicks();
+	if (ticks == 0) {
+		// The engine clock is sampled once per frame, so the wake-up may be slightly early.
+		Schedule();
+		return;
+	}
 	m_timer.ResetTicks();
 
 	if (m_on_tick.IsNull() == false && m_on_tick->IsNull() == false) {
@@ -22,20 +53,61 @@ void retro3d::TimerComponent::OnUpdate( void )
 	if (m_tick_count > -1 && (m_tick_count -= ticks) == 0) {
 		Destroy();
 	}
+
+	if (IsDestroyed() == false) {
+		Schedule();
+	}
+}
+
+void retro3d::TimerComponent::OnSpawn( void )
+{
+	m_timer = this->GetObject()->CreateGameTimer();
+	m_timer_type = retro3d::TIMER_GAME;
+	m_is_spawned = true;
+	Schedule();
 }
 
 void retro3d::TimerComponent::OnDestroy( void )
 {
+	Unschedule();
 	if (m_on_destroy.IsNull() == false) {
 		(*m_on_destroy.GetShared())();
 	}
 }
 
-retro3d::TimerComponent::TimerComponent( void ) : mtlInherit(this), m_timer(), m_tick_count(-1), m_on_tick(), m_on_destroy(), m_multitick(false)
+retro3d::TimerComponent::TimerComponent( void ) : mtlInherit(this), m_timer(), m_wake(), m_timer_type(retro3d::TIMER_GAME), m_tick_count(-1), m_on_tick(), m_on_destroy(), m_multitick(false), m_is_spawned(false)
 {}
 
+bool retro3d::TimerComponent::WriteSnapshot(retro3d::SnapshotWriter &out) const
+{
+	out.Write(m_timer.GetScaledTime());
+	out.Write(m_tick_count);
+	out.Write(m_timer.IsTicking());
+	return true;
+}
+
+bool retro3d::TimerComponent::ReadSnapshot(retro3d::SnapshotReader &in)
+{
+	retro3d::Time time;
+	int64_t tick_count;
+	bool ticking;
+	if (in.Read(time) == false || in.Read(tick_count) == false || in.Read(ticking) == false) {
+		return false;
+	}
+	m_timer.SetScaledTime(time);
+	m_tick_count = tick_count;
+	if (ticking == true) {
+		m_timer.Start();
+	} else {
+		m_timer.Pause();
+	}
+	Schedule();
+	return true;
+}
+
 void retro3d::TimerComponent::SetTickRate(retro3d::TimerType timer_type, uint32_t num_ticks, retro3d::Time over_time)
 {
+	Unschedule();
 	switch (timer_type) {
 	case retro3d::TIMER_REAL:
 		m_timer = retro3d::RealTimeTimer(num_ticks, over_time);
@@ -47,21 +119,26 @@ void retro3d::TimerComponent::SetTickRate(retro3d::TimerType timer_type, uint32_
 		m_timer = GetObject()->CreateGameTimer(num_ticks, over_time);
 		break;
 	}
+	m_timer_type = timer_type;
+	Schedule();
 }
 
 void retro3d::TimerComponent::Start( void )
 {
 	m_timer.Start();
+	Schedule();
 }
 
 void retro3d::TimerComponent::Pause( void )
 {
 	m_timer.Pause();
+	Unschedule();
 }
 
 void retro3d::TimerComponent::Reset( void )
 {
 	m_timer.Reset();
+	Schedule();
 }
 
 void retro3d::TimerComponent::SetOnTick(const mtlShared<retro3d::IProcedure> &procedure)
@@ -3,27 +3,44 @@
 
 #include "../retro_entity.h"
 #include "../../common/retro_defs.h"
+#include "../../common/retro_timer_wheel.h"
 
 namespace retro3d
 {
 
+// Calls a procedure every time the timer ticks.
+// NOTE: The component is woken by the engine timer wheel when the next tick is due instead of polling the timer every frame.
 retro_component(TimerComponent)
 {
+	friend class retro3d::Entity;
+
 private:
 	retro3d::RealTimeTimer         m_timer;
+	retro3d::TimerHandle           m_wake;
+	retro3d::TimerType             m_timer_type;
 	int64_t                        m_tick_count;
 	mtlShared<retro3d::IProcedure> m_on_tick;
 	mtlShared<retro3d::IProcedure> m_on_destroy;
 	bool                           m_multitick;
+	bool                           m_is_spawned;
+
+private:
+	// Schedules a wake-up for when the next tick is estimated to be due. Called whenever the estimate may have changed.
+	void Schedule( void );
+	void Unschedule( void );
+	void Wake( void );
 
 protected:
 	void OnSpawn( void );
-	void OnUpdate( void );
 	void OnDestroy( void );
 
 public:
 	TimerComponent( void );
 
+	// Snapshots hold the time on the timer, whether it is ticking and the number of ticks left. The tick rate and procedures are not included.
+	bool WriteSnapshot(retro3d::SnapshotWriter &out) const override;
+	bool ReadSnapshot(retro3d::SnapshotReader &in) override;
+
 	void SetTickRate(retro3d::TimerType timer_type, uint32_t num_ticks, retro3d::Time over_time = 1_s);
 
 	void Start( void );
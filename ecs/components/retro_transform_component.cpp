@@ -1,12 +1,63 @@
 #include "retro_transform_component.h"
+#include "../../common/MiniLib/MML/mmlMath.h"
+#include "../../serial/retro_snapshot.h"
 
 namespace retro3d { retro_register_component(TransformComponent) }
 
-void retro3d::TransformComponent::OnUpdate( void )
+void retro3d::TransformComponent::OnSpawn( void )
 {
 	m_old_transform = m_transform->GetFinalMatrix();
 }
 
+void retro3d::TransformComponent::RecordLastTransform( void )
+{
+	m_old_transform = m_transform->GetFinalMatrix();
+}
+
+namespace
+{
+
+void WriteMatrix(retro3d::SnapshotWriter &out, const mmlMatrix<4,4> &m)
+{
+	for (int r = 0; r < 4; ++r) {
+		for (int c = 0; c < 4; ++c) {
+			out.Write(float(m[r][c]));
+		}
+	}
+}
+
+bool ReadMatrix(retro3d::SnapshotReader &in, mmlMatrix<4,4> &m)
+{
+	for (int r = 0; r < 4; ++r) {
+		for (int c = 0; c < 4; ++c) {
+			float x = 0.0f;
+			in.Read(x);
+			m[r][c] = x;
+		}
+	}
+	return in.IsFailed() == false;
+}
+
+}
+
+bool retro3d::TransformComponent::WriteSnapshot(retro3d::SnapshotWriter &out) const
+{
+	WriteMatrix(out, *m_transform);
+	WriteMatrix(out, m_old_transform);
+	return true;
+}
+
+bool retro3d::TransformComponent::ReadSnapshot(retro3d::SnapshotReader &in)
+{
+	mmlMatrix<4,4> transform, old_transform;
+	if (ReadMatrix(in, transform) == false || ReadMatrix(in, old_transform) == false) {
+		return false;
+	}
+	m_transform->SetTransform(transform);
+	m_old_transform.SetTransform(old_transform);
+	return true;
+}
+
 retro3d::TransformComponent::TransformComponent( void ) : mtlInherit(this), m_old_transform()
 {
 	m_transform.New();
@@ -31,3 +82,19 @@ retro3d::Transform retro3d::TransformComponent::GetLastTransform( void ) const
 {
 	return m_old_transform;
 }
+
+mmlMatrix<4,4> retro3d::TransformComponent::GetInterpolatedMatrix(double alpha) const
+{
+	const mmlMatrix<4,4> current = m_transform->GetFinalMatrix();
+	if (alpha >= 1.0) {
+		return current;
+	}
+	const float t = float(mmlMax(alpha, 0.0));
+	mmlMatrix<4,4> m;
+	for (int r = 0; r < 4; ++r) {
+		for (int c = 0; c < 4; ++c) {
+			m[r][c] = m_old_transform[r][c] + (current[r][c] - m_old_transform[r][c]) * t;
+		}
+	}
+	return m;
+}
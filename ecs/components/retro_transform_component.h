@@ -16,16 +16,28 @@ private:
 	retro3d::Transform       m_old_transform; // or should we store next_transform?
 
 protected:
-	void OnUpdate( void );
+	void OnSpawn( void );
 
 public:
 	TransformComponent( void );
 
+	// Snapshots hold the local transform and the transform of the previous update.
+	bool WriteSnapshot(retro3d::SnapshotWriter &out) const override;
+	bool ReadSnapshot(retro3d::SnapshotReader &in) override;
+
 	const retro3d::SharedTransform GetTransform( void ) const;
 	retro3d::SharedTransform       GetTransform( void );
 
+	// Stores the current final matrix as the last transform.
+	// NOTE: Called by the engine for every transform before each update, not meant to be called elsewhere.
+	void RecordLastTransform( void );
+
 	mmlVector<3> GetLastMove( void ) const;
 	retro3d::Transform GetLastTransform( void ) const;
+
+	// Returns the final matrix blended between the last and the current transform. An alpha of 1 or more returns the current final matrix.
+	// NOTE: The matrices are blended element-wise, which is accurate enough for the small rotations between two simulation steps.
+	mmlMatrix<4,4> GetInterpolatedMatrix(double alpha) const;
 };
 
 }
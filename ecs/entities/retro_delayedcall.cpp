@@ -1,12 +1,36 @@
 #include "retro_delayedcall.h"
 
-void retro3d::DelayedCall::OnUpdate( void )
+void retro3d::DelayedCall::Schedule( void )
 {
-	if (LifeTime(m_timer_type) >= m_time) {
+	// NOTE: Game lifetime runs at the entity time scale relative to the engine game clock. Any remaining time after a wake-up is rescheduled.
+	const retro3d::Time lifetime = LifeTime(m_timer_type);
+	const retro3d::Time left = m_time > lifetime ? m_time - lifetime : retro3d::Time(0);
+	const double time_scale = m_timer_type == retro3d::TIMER_GAME && GetTimeScale() > 0.0 ? GetTimeScale() : 1.0;
+	m_wake = GetEngine()->GetTimerWheel(m_timer_type)->Schedule(retro3d::Time::FloatSeconds(left.GetFloatSeconds() / time_scale), [this]( void ) { Wake(); });
+}
+
+void retro3d::DelayedCall::Wake( void )
+{
+	m_wake = retro3d::TimerHandle();
+	if (IsDestroyed() == true) { return; }
+
+	if (IsActive() == true && LifeTime(m_timer_type) >= m_time) {
 		(*m_procedure.GetShared())();
 		Destroy();
+	} else {
+		Schedule();
 	}
 }
 
-retro3d::DelayedCall::DelayedCall(const mtlShared<retro3d::IProcedure> &procedure, retro3d::Time time, retro3d::TimerType timer_type) : mtlInherit(this), m_time(time), m_timer_type(timer_type), m_procedure(procedure)
+void retro3d::DelayedCall::OnSpawn( void )
+{
+	Schedule();
+}
+
+void retro3d::DelayedCall::OnDestroy( void )
+{
+	GetEngine()->GetTimerWheel(m_timer_type)->Cancel(m_wake);
+}
+
+retro3d::DelayedCall::DelayedCall(const mtlShared<retro3d::IProcedure> &procedure, retro3d::Time time, retro3d::TimerType timer_type) : mtlInherit(this), m_time(time), m_timer_type(timer_type), m_procedure(procedure), m_wake()
 {}
@@ -4,19 +4,28 @@
 #include "../retro_entity.h"
 #include "../../common/retro_defs.h"
 #include "../../common/retro_time.h"
+#include "../../common/retro_timer_wheel.h"
 
 namespace retro3d
 {
 
+// Calls a procedure once the entity has existed for the given time, then destroys itself.
+// NOTE: The call is scheduled on the engine timer wheel instead of checking the time every frame.
 class DelayedCall : public mtlInherit< retro3d::Entity, DelayedCall >
 {
 private:
 	retro3d::Time                  m_time;
 	retro3d::TimerType             m_timer_type;
 	mtlShared<retro3d::IProcedure> m_procedure;
+	retro3d::TimerHandle           m_wake;
+
+private:
+	void Schedule( void );
+	void Wake( void );
 
 protected:
-	virtual void OnUpdate( void );
+	virtual void OnSpawn( void );
+	virtual void OnDestroy( void );
 
 public:
 	DelayedCall( void ) = delete;
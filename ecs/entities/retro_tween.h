@@ -41,6 +41,16 @@ public:
 	void Cancel( void );
 };
 
+// Moves the target to the value interpolated to d (0-1) between from and to. 'current' is the value last applied by the tween, which relative modes add the difference to.
+template < typename type_t >
+void ApplyTween(retro3d::ITween::Mode mode, type_t &target, type_t &current, const type_t &from, const type_t &to, float d);
+
+// Moves the target to the end value of the tween.
+template < typename type_t >
+void FinishTween(retro3d::ITween::Mode mode, type_t &target, type_t &current, const type_t &to);
+
+// A tween that is its own entity.
+// NOTE: Each tween costs a full entity. Prefer TweenSystem when tweening many values.
 template < typename type_t >
 class Tween : public mtlInherit< ITween, Tween<type_t> >
 {
@@ -65,39 +75,67 @@ public:
 
 }
 
+template < typename type_t >
+void retro3d::ApplyTween(retro3d::ITween::Mode mode, type_t &target, type_t &current, const type_t &from, const type_t &to, float d)
+{
+	const type_t y = current;
+
+	switch (mode) {
+	case retro3d::ITween::MODE_REL_LERP:
+		current = mmlLerp(from, to, d);
+		target += (current - y);
+		break;
+	case retro3d::ITween::MODE_REL_SLERP:
+		current = mmlSlerp(from, to, d);
+		target += (current - y);
+		break;
+	case retro3d::ITween::MODE_REL_QLERP:
+		current = mmlQlerp(from, to, d);
+		target += (current - y);
+		break;
+	case retro3d::ITween::MODE_ABS_LERP:
+		target = mmlLerp(from, to, d);
+		current = target;
+		break;
+	case retro3d::ITween::MODE_ABS_SLERP:
+		target = mmlSlerp(from, to, d);
+		current = target;
+		break;
+	case retro3d::ITween::MODE_ABS_QLERP:
+		target = mmlQlerp(from, to, d);
+		current = target;
+		break;
+	}
+}
+
+template < typename type_t >
+void retro3d::FinishTween(retro3d::ITween::Mode mode, type_t &target, type_t &current, const type_t &to)
+{
+	const type_t y = current;
+
+	switch (mode) {
+	case retro3d::ITween::MODE_REL_LERP:
+	case retro3d::ITween::MODE_REL_SLERP:
+	case retro3d::ITween::MODE_REL_QLERP:
+		current = to;
+		target += (current - y);
+		break;
+	case retro3d::ITween::MODE_ABS_LERP:
+	case retro3d::ITween::MODE_ABS_SLERP:
+	case retro3d::ITween::MODE_ABS_QLERP:
+		target = to;
+		current = to;
+		break;
+	}
+}
+
 template < typename type_t >
 void retro3d::Tween<type_t>::OnUpdate( void )
 {
-	const float  d = mmlClamp(0.0f, float((Entity::LifeTime(ITween::m_timer_type) / ITween::m_duration).GetFloatSeconds()), 1.0f);
-	const type_t y = x0;
+	const float d = mmlClamp(0.0f, float((Entity::LifeTime(ITween::m_timer_type) / ITween::m_duration).GetFloatSeconds()), 1.0f);
 
 	if (x != nullptr) {
-		switch (ITween::m_mode) {
-		case ITween::MODE_REL_LERP:
-			x0 = mmlLerp(a, b, d);
-			*x += (x0 - y);
-			break;
-		case ITween::MODE_REL_SLERP:
-			x0 = mmlSlerp(a, b, d);
-			*x += (x0 - y);
-			break;
-		case ITween::MODE_REL_QLERP:
-			x0 = mmlQlerp(a, b, d);
-			*x += (x0 - y);
-			break;
-		case ITween::MODE_ABS_LERP:
-			*x = mmlLerp(a, b, d);
-			x0 = x;
-			break;
-		case ITween::MODE_ABS_SLERP:
-			*x = mmlSlerp(a, b, d);
-			x0 = x;
-			break;
-		case ITween::MODE_ABS_QLERP:
-			*x = mmlQlerp(a, b, d);
-			x0 = x;
-			break;
-		}
+		retro3d::ApplyTween(ITween::m_mode, *x, x0, a, b, d);
 	}
 
 	if (d >= 1.0f) {
@@ -115,22 +153,7 @@ template < typename type_t >
 void retro3d::Tween<type_t>::Finish( void )
 {
 	if (x != nullptr) {
-		const type_t y = x0;
-
-		switch (ITween::m_mode) {
-		case ITween::MODE_REL_LERP:
-		case ITween::MODE_REL_SLERP:
-		case ITween::MODE_REL_QLERP:
-			x0 = b;
-			*x += (x0 - y);
-			break;
-		case ITween::MODE_ABS_LERP:
-		case ITween::MODE_ABS_SLERP:
-		case ITween::MODE_ABS_QLERP:
-			*x = b;
-			x0 = b;
-			break;
-		}
+		retro3d::FinishTween(ITween::m_mode, *x, x0, b);
 	}
 	Entity::Destroy();
 }
@@ -14,6 +14,16 @@ void retro3d::Component::OnCollision(retro3d::Entity&)
 void retro3d::Component::OnDestroy( void )
 {}
 
+bool retro3d::Component::WriteSnapshot(retro3d::SnapshotWriter&) const
+{
+	return false;
+}
+
+bool retro3d::Component::ReadSnapshot(retro3d::SnapshotReader&)
+{
+	return false;
+}
+
 retro3d::Component::Component( void ) :
 	mtlInherit(this), m_object(nullptr), m_is_active(1), m_should_destroy(false)
 {}
@@ -23,7 +33,11 @@ retro3d::Component::~Component( void )
 
 void retro3d::Component::Destroy( void )
 {
-	m_should_destroy = true;
+	if (m_object != nullptr && m_object->GetEngine() != nullptr) {
+		m_object->GetEngine()->EnqueueDestroy(this);
+	} else {
+		m_should_destroy = true;
+	}
 }
 
 bool retro3d::Component::IsDestroyed( void ) const
@@ -39,11 +53,17 @@ bool retro3d::Component::IsActive( void ) const
 void retro3d::Component::Deactivate( void )
 {
 	--m_is_active;
+	if (m_object != nullptr && m_object->GetEngine() != nullptr) {
+		m_object->GetEngine()->MarkActivityChanged(this);
+	}
 }
 
 void retro3d::Component::Activate( void )
 {
 	m_is_active = mmlMin(1, m_is_active + 1);
+	if (m_object != nullptr && m_object->GetEngine() != nullptr) {
+		m_object->GetEngine()->MarkActivityChanged(this);
+	}
 }
 
 retro3d::Entity *retro3d::Component::GetObject( void )
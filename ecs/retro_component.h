@@ -14,10 +14,14 @@ class Engine;
 class RenderDevice;
 class SoundDevice;
 class InputDevice;
+class SnapshotWriter;
+class SnapshotReader;
+class IComponentPool;
 
 class Component : public mtlInherit<retro3d::Serializeable, Component>
 {
 	friend class Engine;
+	friend class IComponentPool;
 
 private:
 	retro3d::Entity  *m_object;
@@ -40,6 +44,12 @@ public:
 	void Destroy( void );
 	bool IsDestroyed( void ) const;
 
+	// Writes the state of the component to an engine snapshot. Component types opt in by overriding this and ReadSnapshot, by default nothing is written and false is returned.
+	virtual bool WriteSnapshot(retro3d::SnapshotWriter &out) const;
+
+	// Restores the state written by WriteSnapshot. Returns false if the data could not be read.
+	virtual bool ReadSnapshot(retro3d::SnapshotReader &in);
+
 	bool IsActive( void ) const;
 	void Deactivate( void );
 	void Activate( void );
@@ -0,0 +1,170 @@
+#include "retro_component_pool.h"
+#include "retro_entity.h"
+
+void retro3d::IComponentPool::Swap(uint32_t slot_a, uint32_t slot_b)
+{
+	if (slot_a == slot_b) { return; }
+	std::swap(m_dense[slot_a], m_dense[slot_b]);
+	std::swap(m_dense_entity[slot_a], m_dense_entity[slot_b]);
+	m_sparse[m_dense_entity[slot_a]] = slot_a + 1;
+	m_sparse[m_dense_entity[slot_b]] = slot_b + 1;
+}
+
+void retro3d::IComponentPool::SetActive(uint32_t slot, bool active)
+{
+	if (active == true && slot >= m_active_count) {
+		Swap(slot, m_active_count);
+		++m_active_count;
+	} else if (active == false && slot < m_active_count) {
+		--m_active_count;
+		Swap(slot, m_active_count);
+	}
+}
+
+void retro3d::IComponentPool::Retire(uint32_t entity_index)
+{
+	if (entity_index >= m_generations.size()) {
+		m_generations.resize(size_t(entity_index) + 1, 0);
+	}
+	++m_generations[entity_index];
+}
+
+retro3d::IComponentPool::IComponentPool(uint64_t class_type) :
+	m_active_count(0), m_class_type(class_type)
+{}
+
+retro3d::IComponentPool::~IComponentPool( void )
+{}
+
+void retro3d::IComponentPool::Insert(uint32_t entity_index, retro3d::Component *c)
+{
+	if (entity_index >= m_sparse.size()) {
+		m_sparse.resize(size_t(entity_index) + 1, 0);
+	}
+	m_dense.push_back(c);
+	m_dense_entity.push_back(entity_index);
+	m_sparse[entity_index] = uint32_t(m_dense.size());
+	SetActive(uint32_t(m_dense.size() - 1), c->IsActive());
+}
+
+void retro3d::IComponentPool::MarkChanged(uint32_t entity_index)
+{
+	std::lock_guard<std::mutex> lock(m_changed_mutex);
+	m_changed.push_back(entity_index);
+}
+
+void retro3d::IComponentPool::Repartition( void )
+{
+	// NOTE: Pending components are not in the dense array yet. Their activity is checked when they are inserted.
+	for (size_t i = 0; i < m_changed.size(); ++i) {
+		const uint32_t entity_index = m_changed[i];
+		if (entity_index < m_sparse.size() && m_sparse[entity_index] > 0) {
+			const uint32_t slot = m_sparse[entity_index] - 1;
+			SetActive(slot, m_dense[slot]->IsActive());
+		}
+	}
+	m_changed.clear();
+}
+
+retro3d::Component *retro3d::IComponentPool::Remove(uint32_t entity_index)
+{
+	if (entity_index >= m_sparse.size() || m_sparse[entity_index] == 0) {
+		return nullptr;
+	}
+	uint32_t slot = m_sparse[entity_index] - 1;
+	if (slot < m_active_count) {
+		--m_active_count;
+		Swap(slot, m_active_count);
+		slot = m_active_count;
+	}
+	const uint32_t last = uint32_t(m_dense.size()) - 1;
+	retro3d::Component *c = m_dense[slot];
+	if (slot != last) {
+		m_dense[slot] = m_dense[last];
+		m_dense_entity[slot] = m_dense_entity[last];
+		m_sparse[m_dense_entity[slot]] = slot + 1;
+	}
+	m_dense.pop_back();
+	m_dense_entity.pop_back();
+	m_sparse[entity_index] = 0;
+	Retire(entity_index);
+	return c;
+}
+
+bool retro3d::IComponentPool::AddPending(uint32_t entity_index, retro3d::Component *c)
+{
+	if (entity_index >= m_pending_sparse.size()) {
+		m_pending_sparse.resize(size_t(entity_index) + 1, 0);
+	}
+	m_pending.push_back(c);
+	m_pending_sparse[entity_index] = uint32_t(m_pending.size());
+	return m_pending.size() == 1;
+}
+
+void retro3d::IComponentPool::CommitPending(std::vector<retro3d::Component*> &committed)
+{
+	m_dense.reserve(m_dense.size() + m_pending.size());
+	m_dense_entity.reserve(m_dense_entity.size() + m_pending.size());
+	for (size_t i = 0; i < m_pending.size(); ++i) {
+		const uint32_t entity_index = m_pending[i]->GetObject()->m_index;
+		Insert(entity_index, m_pending[i]);
+		m_pending_sparse[entity_index] = 0;
+	}
+	committed.insert(committed.end(), m_pending.begin(), m_pending.end());
+	m_pending.clear();
+}
+
+void retro3d::IComponentPool::AddDestroyed(retro3d::Component *c)
+{
+	std::lock_guard<std::mutex> lock(m_destroyed_mutex);
+	if (c->m_should_destroy == true) { return; }
+	c->m_should_destroy = true;
+	m_destroyed.push_back(c);
+}
+
+void retro3d::IComponentPool::CollectDestroyed(std::vector<retro3d::Component*> &destroyed)
+{
+	size_t n = 0;
+	for (size_t i = 0; i < m_destroyed.size(); ++i) {
+		retro3d::Component *c = m_destroyed[i];
+		if (Get(c->GetObject()->m_index) == c) {
+			destroyed.push_back(c);
+		} else if (c->GetObject()->IsDestroyed() == false) {
+			m_destroyed[n++] = c;
+		} // NOTE: Pending components of destroyed entities are deleted by PurgePending.
+	}
+	m_destroyed.resize(n);
+}
+
+void retro3d::IComponentPool::PurgePending( void )
+{
+	size_t n = 0;
+	for (size_t i = 0; i < m_pending.size(); ++i) {
+		retro3d::Component *c = m_pending[i];
+		const uint32_t entity_index = c->GetObject()->m_index;
+		if (c->GetObject()->IsDestroyed() == true) {
+			m_pending_sparse[entity_index] = 0;
+			Retire(entity_index);
+			Delete(c);
+		} else {
+			m_pending[n++] = c;
+			m_pending_sparse[entity_index] = uint32_t(n);
+		}
+	}
+	m_pending.resize(n);
+}
+
+void retro3d::IComponentPool::DeletePending( void )
+{
+	for (size_t i = 0; i < m_pending.size(); ++i) {
+		m_pending_sparse[m_pending[i]->GetObject()->m_index] = 0;
+		Retire(m_pending[i]->GetObject()->m_index);
+		Delete(m_pending[i]);
+	}
+	m_pending.clear();
+}
+
+uint64_t retro3d::IComponentPool::GetClassType( void ) const
+{
+	return m_class_type;
+}
@@ -0,0 +1,207 @@
+#ifndef RETRO_COMPONENT_POOL_H
+#define RETRO_COMPONENT_POOL_H
+
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+#include "../common/MiniLib/MTL/mtlType.h"
+#include "retro_component.h"
+
+#define RETRO3D_COMPONENT_SLAB_SIZE 64 // Number of components allocated at once by a component pool.
+
+namespace retro3d
+{
+
+// Stores all live components of a single class in a dense array with a sparse entity index lookup.
+// NOTE: Components are handed out as raw pointers and can not be moved, so the dense array stores pointers into slab memory rather than the components themselves.
+// NOTE: The dense array is partitioned so that active components come first, which lets update loops skip inactive components without touching them.
+class IComponentPool
+{
+private:
+	std::vector<retro3d::Component*> m_dense;        // Live components without gaps. Active components are stored before inactive components.
+	std::vector<uint32_t>            m_dense_entity; // Entity index of each component in m_dense.
+	std::vector<uint32_t>            m_sparse;       // Entity index -> slot in m_dense + 1. 0 means that the entity has no component in the pool.
+	uint32_t                         m_active_count; // Number of components at the start of m_dense that were active at the last repartition.
+	std::vector<retro3d::Component*> m_pending;        // Components added this frame, in the order they were added.
+	std::vector<uint32_t>            m_pending_sparse; // Entity index -> slot in m_pending + 1.
+	std::vector<retro3d::Component*> m_destroyed;      // Components marked for destruction since the last call to CollectDestroyed.
+	std::vector<uint32_t>            m_changed;        // Entity indices of components that may have changed activity since the last repartition.
+	std::vector<uint32_t>            m_generations;    // Entity index -> number of components of the entity that have left the pool.
+	std::mutex                       m_changed_mutex;
+	std::mutex                       m_destroyed_mutex;
+	uint64_t                         m_class_type;
+
+private:
+	void Swap(uint32_t slot_a, uint32_t slot_b);
+	void SetActive(uint32_t slot, bool active);
+	void Retire(uint32_t entity_index);
+
+public:
+	// Construction.
+	explicit IComponentPool(uint64_t class_type);
+	virtual ~IComponentPool( void );
+
+	IComponentPool(const IComponentPool&) = delete;
+	IComponentPool &operator=(const IComponentPool&) = delete;
+
+	// Inserts a live component belonging to the entity with the given index.
+	void Insert(uint32_t entity_index, retro3d::Component *c);
+
+	// Notes that the component belonging to the entity with the given index may have been activated or deactivated. Safe to call from several threads at once.
+	void MarkChanged(uint32_t entity_index);
+
+	// Moves components marked as changed to the active or inactive part of the dense array.
+	// NOTE: Reorders components, so never call this while iterating over the pool.
+	void Repartition( void );
+
+	// Removes the component belonging to the entity with the given index by moving the last component in its place. Does not free the component.
+	retro3d::Component *Remove(uint32_t entity_index);
+
+	// Returns the component belonging to the entity with the given index. Null if the entity has no component in the pool.
+	retro3d::Component *Get(uint32_t entity_index) const;
+
+	// Appends a component that will become live on the next call to CommitPending. Returns true if it is the first pending component in the pool.
+	bool AddPending(uint32_t entity_index, retro3d::Component *c);
+
+	// Returns the pending component belonging to the entity with the given index. Null if there is none.
+	retro3d::Component *GetPending(uint32_t entity_index) const;
+
+	// Returns the generation of the component slot of the entity with the given index. Bumped every time a live or pending component leaves the slot, so handles to a removed component never resolve to a component added later. Starts at 1.
+	uint32_t GetGeneration(uint32_t entity_index) const;
+
+	// Inserts all pending components in a single pass and appends them to 'committed'.
+	// NOTE: Components added while processing 'committed' are pending until the next commit.
+	void CommitPending(std::vector<retro3d::Component*> &committed);
+
+	// Queues a component marked for destruction.
+	void AddDestroyed(retro3d::Component *c);
+
+	// Appends queued live components to 'destroyed'. Queued components that are still pending stay queued until they are live, unless their entity is destroyed.
+	// NOTE: Must be called before PurgePending.
+	void CollectDestroyed(std::vector<retro3d::Component*> &destroyed);
+
+	// Deletes pending components whose entities are destroyed.
+	void PurgePending( void );
+
+	// Deletes all pending components.
+	void DeletePending( void );
+
+	// Returns the number of live components.
+	uint32_t GetSize( void ) const;
+
+	// Returns the number of live components that were active at the last repartition. These are stored at dense indices 0 to GetActiveCount() - 1.
+	// NOTE: Components may have been deactivated since, so check IsActive before updating them.
+	uint32_t GetActiveCount( void ) const;
+
+	// Returns the live component at the given dense index.
+	retro3d::Component *operator[](uint32_t i) const;
+
+	// Returns the class ID of the components in the pool.
+	uint64_t GetClassType( void ) const;
+
+	// Calls the destructor of a component allocated by the pool and returns its memory to the pool.
+	virtual void Delete(retro3d::Component *c) = 0;
+};
+
+// Allocates components of a single class from fixed-size slabs.
+template < typename component_t >
+class ComponentPool : public IComponentPool
+{
+private:
+	struct alignas(component_t) Slab
+	{
+		unsigned char memory[sizeof(component_t) * RETRO3D_COMPONENT_SLAB_SIZE];
+	};
+
+private:
+	std::vector<Slab*>        m_slabs;
+	std::vector<component_t*> m_free;
+
+public:
+	// Construction.
+	ComponentPool( void );
+	~ComponentPool( void ) override;
+
+	// Constructs a new component in pool memory. The component is not live until inserted.
+	template < typename... Args > component_t *New(Args&&... args);
+
+	// Calls the destructor of a component allocated by the pool and returns its memory to the pool.
+	void Delete(retro3d::Component *c) override;
+};
+
+}
+
+inline retro3d::Component *retro3d::IComponentPool::Get(uint32_t entity_index) const
+{
+	return (entity_index < m_sparse.size() && m_sparse[entity_index] > 0) ? m_dense[m_sparse[entity_index] - 1] : nullptr;
+}
+
+inline retro3d::Component *retro3d::IComponentPool::GetPending(uint32_t entity_index) const
+{
+	return (entity_index < m_pending_sparse.size() && m_pending_sparse[entity_index] > 0) ? m_pending[m_pending_sparse[entity_index] - 1] : nullptr;
+}
+
+inline uint32_t retro3d::IComponentPool::GetGeneration(uint32_t entity_index) const
+{
+	return (entity_index < m_generations.size() ? m_generations[entity_index] : 0) + 1;
+}
+
+inline uint32_t retro3d::IComponentPool::GetSize( void ) const
+{
+	return uint32_t(m_dense.size());
+}
+
+inline uint32_t retro3d::IComponentPool::GetActiveCount( void ) const
+{
+	return m_active_count;
+}
+
+inline retro3d::Component *retro3d::IComponentPool::operator[](uint32_t i) const
+{
+	return m_dense[i];
+}
+
+template < typename component_t >
+retro3d::ComponentPool<component_t>::ComponentPool( void ) :
+	IComponentPool(component_t::GetClassType())
+{}
+
+template < typename component_t >
+retro3d::ComponentPool<component_t>::~ComponentPool( void )
+{
+	// NOTE: Components still alive at this point are leaked by the owner, only the memory is released here.
+	for (size_t i = 0; i < m_slabs.size(); ++i) {
+		delete m_slabs[i];
+	}
+}
+
+template < typename component_t >
+template < typename... Args >
+component_t *retro3d::ComponentPool<component_t>::New(Args&&... args)
+{
+	if (m_free.empty() == true) {
+		Slab *slab = new Slab;
+		m_slabs.push_back(slab);
+		component_t *first = reinterpret_cast<component_t*>(slab->memory);
+		for (int32_t i = RETRO3D_COMPONENT_SLAB_SIZE - 1; i >= 0; --i) { // NOTE: Reverse order so that components are handed out in address order.
+			m_free.push_back(first + i);
+		}
+	}
+	component_t *c = m_free.back();
+	m_free.pop_back();
+	return new (c) component_t(std::forward<Args>(args)...);
+}
+
+template < typename component_t >
+void retro3d::ComponentPool<component_t>::Delete(retro3d::Component *c)
+{
+	if (c != nullptr) {
+		component_t *t = mtlCast<component_t>(c);
+		t->~component_t();
+		m_free.push_back(t);
+	}
+}
+
+#endif // RETRO_COMPONENT_POOL_H
@@ -1,5 +1,6 @@
 #include "../common/MiniLib/MML/mmlMath.h"
 #include "retro_entity.h"
+#include "components/retro_timer_component.h"
 
 void retro3d::Entity::OnSpawn( void )
 {}
@@ -15,10 +16,10 @@ void retro3d::Entity::OnDestroy( void )
 
 retro3d::Entity::Entity( void ) :
 	mtlInherit(this),
-	m_tag("entity"), m_filter_flags(1), m_uuid(reinterpret_cast<uint64_t>(this)),
-	m_engine(nullptr),
+	m_tag("entity"), m_filter_flags(1), m_uuid(reinterpret_cast<uint64_t>(this)), m_index(0), m_tag_slot(0),
+	m_engine(nullptr), m_item(nullptr),
 	m_game_timer(1, 1_s),
-	m_delta_time(0.0),
+	m_time_scale(1.0),
 	m_is_active(1), m_should_destroy(false)
 {
 	m_game_timer.Start();
@@ -26,7 +27,11 @@ retro3d::Entity::Entity( void ) :
 
 void retro3d::Entity::Destroy( void )
 {
-	m_should_destroy = true;
+	if (m_engine != nullptr) {
+		m_engine->EnqueueDestroy(this);
+	} else {
+		m_should_destroy = true;
+	}
 }
 
 bool retro3d::Entity::IsDestroyed( void ) const
@@ -39,17 +44,52 @@ bool retro3d::Entity::IsActive( void ) const
 	return !IsDestroyed() && m_is_active > 0;
 }
 
+void retro3d::Entity::SyncGameTime( void )
+{
+	m_game_time_base = GameLifeTime();
+	if (m_engine != nullptr) {
+		m_game_time_anchor = m_engine->m_game_time;
+	}
+}
+
+void retro3d::Entity::RescheduleTimers( void )
+{
+	if (m_engine != nullptr && m_item != nullptr) {
+		retro3d::TimerComponent *timer = GetComponent<retro3d::TimerComponent>();
+		if (timer != nullptr) {
+			timer->Schedule();
+		}
+	}
+}
+
 void retro3d::Entity::Deactivate( void )
 {
+	if (m_is_active > 0) {
+		SyncGameTime();
+	}
 	--m_is_active;
 	m_game_timer.Pause();
+	if (m_engine != nullptr && m_item != nullptr) {
+		m_engine->MarkActivityChanged(this);
+	}
 }
 
 void retro3d::Entity::Activate( void )
 {
+	const bool was_active = m_is_active > 0;
+	if (was_active == false) {
+		// NOTE: Synced while still inactive so that the time spent inactive is not counted as game time.
+		SyncGameTime();
+	}
 	m_is_active = mmlMin(1, m_is_active + 1);
 	if (m_is_active > 0) {
 		m_game_timer.Start();
+		if (was_active == false) {
+			RescheduleTimers();
+		}
+	}
+	if (m_engine != nullptr && m_item != nullptr) {
+		m_engine->MarkActivityChanged(this);
 	}
 }
 
@@ -58,6 +98,11 @@ uint64_t retro3d::Entity::GetUUID( void ) const
 	return m_uuid;
 }
 
+retro3d::EntityHandle retro3d::Entity::GetHandle( void ) const
+{
+	return m_engine != nullptr ? m_engine->GetHandle(*this) : retro3d::EntityHandle();
+}
+
 const retro3d::Engine *retro3d::Entity::GetEngine( void ) const
 {
 	return m_engine;
@@ -105,7 +150,13 @@ const std::string &retro3d::Entity::GetTag( void ) const
 
 void retro3d::Entity::SetTag(const std::string &tag)
 {
-	m_tag = tag;
+	if (m_engine != nullptr && m_item != nullptr) {
+		m_engine->RemoveEntityTag(this);
+		m_tag = tag;
+		m_engine->AddEntityTag(this);
+	} else {
+		m_tag = tag;
+	}
 }
 
 retro3d::Time retro3d::Entity::RealLifeTime( void ) const
@@ -120,7 +171,10 @@ retro3d::Time retro3d::Entity::SimulationLifeTime( void ) const
 
 retro3d::Time retro3d::Entity::GameLifeTime( void ) const
 {
-	return m_game_time;
+	if (m_engine == nullptr || m_is_active <= 0) {
+		return m_game_time_base;
+	}
+	return m_game_time_base + retro3d::Time::FloatSeconds((m_engine->m_game_time - m_game_time_anchor).GetFloatSeconds() * m_time_scale);
 }
 
 retro3d::Time retro3d::Entity::LifeTime(retro3d::TimerType type) const
@@ -135,17 +189,20 @@ retro3d::Time retro3d::Entity::LifeTime(retro3d::TimerType type) const
 
 double retro3d::Entity::DeltaTime( void ) const
 {
-	return m_delta_time;
+	return (m_engine != nullptr && m_is_active > 0) ? m_engine->m_delta_time * m_time_scale : 0.0;
 }
 
 void retro3d::Entity::SetTimeScale(double time_scale)
 {
+	SyncGameTime();
+	m_time_scale = time_scale;
 	m_game_timer.SetTickRate(1, retro3d::Time::FloatSeconds(1.0 / time_scale), false);
+	RescheduleTimers();
 }
 
 double retro3d::Entity::GetTimeScale( void ) const
 {
-	return 1.0 / m_game_timer.GetTimePerTick().GetFloatSeconds();
+	return m_time_scale;
 }
 
 retro3d::RealTimeTimer retro3d::Entity::CreateGameTimer(uint32_t num_ticks, retro3d::Time over_time) const
@@ -175,14 +232,18 @@ bool retro3d::Entity::GetFilterFlag(uint32_t flag_index) const
 
 void retro3d::Entity::SetFilterFlags(uint64_t filter_flags)
 {
+	const uint64_t old_filter_flags = m_filter_flags;
 	m_filter_flags = filter_flags;
+	if (m_engine != nullptr && m_item != nullptr) {
+		m_engine->UpdateEntityFilter(this, old_filter_flags);
+	}
 }
 
 void retro3d::Entity::SetFilterFlag(uint32_t flag_index, bool state)
 {
 	if (state == true) {
-		m_filter_flags |= (uint64_t(1) << flag_index);
+		SetFilterFlags(m_filter_flags | (uint64_t(1) << flag_index));
 	} else {
-		m_filter_flags &= ~(uint64_t(1) << flag_index);
+		SetFilterFlags(m_filter_flags & ~(uint64_t(1) << flag_index));
 	}
 }
@@ -5,7 +5,9 @@
 #include <string>
 #include "../common/retro_time.h"
 #include "../common/MiniLib/MTL/mtlPointer.h"
+#include "../common/MiniLib/MTL/mtlList.h"
 #include "../serial/retro_serialize.h"
+#include "retro_handle.h"
 
 namespace retro3d
 {
@@ -18,20 +20,32 @@ class InputDevice;
 class Entity : public mtlInherit< retro3d::Serializeable, Entity >
 {
 	friend class Engine;
+	friend class IComponentPool;
 
 private:
 	std::string             m_tag;
 	uint64_t                m_filter_flags;
 	const uint64_t          m_uuid;
+	uint32_t                m_index; // Slot assigned by the engine, used to look up components. Reused after the entity is destroyed.
+	uint32_t                m_tag_slot; // Position in the engine's tag index.
 	Engine                 *m_engine;
-	retro3d::RealTimeTimer  m_game_timer;
+	mtlItem<Entity*>       *m_item; // Position in the engine's entity list, allows removal without searching.
+	retro3d::RealTimeTimer  m_game_timer; // Only used as a parent for timers created via CreateGameTimer. Entity time is derived from the engine game time.
 	retro3d::Time           m_real_time_spawn;
 	retro3d::Time           m_sim_time_spawn;
-	retro3d::Time           m_game_time;
-	double                  m_delta_time;
+	retro3d::Time           m_game_time_anchor; // Engine game time when m_game_time_base was last recorded.
+	retro3d::Time           m_game_time_base; // Game lifetime of the entity at m_game_time_anchor.
+	double                  m_time_scale;
 	int32_t                 m_is_active;
 	bool                    m_should_destroy;
 
+private:
+	// Records the current game lifetime so that it can be continued from the current engine game time at a different rate.
+	void SyncGameTime( void );
+
+	// Lets the entity's timer component know that its game timer has changed rate.
+	void RescheduleTimers( void );
+
 protected:
 	// Called immediately after the engine has initialized the entity.
 	virtual void OnSpawn( void );
@@ -69,6 +83,9 @@ public:
 	// Returns this entity's unique instance ID.
 	uint64_t GetUUID( void ) const;
 
+	// Returns a handle to the entity that resolves to null once the entity is deleted. Only valid after the entity has been spawned.
+	retro3d::EntityHandle GetHandle( void ) const;
+
 	// Gets the parent engine.
 	const retro3d::Engine *GetEngine( void ) const;
 	retro3d::Engine       *GetEngine( void );
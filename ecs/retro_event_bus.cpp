@@ -0,0 +1,75 @@
+#include <iostream>
+#include <mutex>
+#include "retro_event_bus.h"
+
+namespace
+{
+
+std::mutex            g_slot_mutex;
+std::vector<uint32_t> g_free_slots;
+uint32_t              g_slot_count = 0;
+
+// Holds the calling thread's event buffer index, and returns it for reuse when the thread exits.
+struct EventThreadSlot
+{
+	uint32_t slot;
+
+	EventThreadSlot( void )
+	{
+		std::lock_guard<std::mutex> lock(g_slot_mutex);
+		if (g_free_slots.empty() == false) {
+			slot = g_free_slots.back();
+			g_free_slots.pop_back();
+		} else {
+			slot = g_slot_count++;
+		}
+		if (slot == RETRO3D_EVENT_BUS_MAX_THREADS) {
+			std::cout << "[EventBus::GetThreadSlot] More than " << RETRO3D_EVENT_BUS_MAX_THREADS << " threads emit events, further threads share a locked buffer." << std::endl;
+		}
+	}
+
+	~EventThreadSlot( void )
+	{
+		std::lock_guard<std::mutex> lock(g_slot_mutex);
+		g_free_slots.push_back(slot);
+	}
+};
+
+thread_local EventThreadSlot t_event_slot;
+
+}
+
+retro3d::EventBus::EventBus( void ) : m_queues(), m_queue_list(), m_next_id(1)
+{}
+
+retro3d::EventBus::~EventBus( void )
+{
+	for (size_t i = 0; i < m_queue_list.size(); ++i) {
+		delete m_queue_list[i];
+	}
+}
+
+uint32_t retro3d::EventBus::GetThreadSlot( void )
+{
+	return t_event_slot.slot;
+}
+
+bool retro3d::EventBus::Unsubscribe(retro3d::EventSubscription subscription)
+{
+	const uint32_t index = subscription.GetIndex();
+	return subscription.IsNull() == false && index < m_queue_list.size() && m_queue_list[index]->Unsubscribe(subscription.GetGeneration());
+}
+
+void retro3d::EventBus::Dispatch( void )
+{
+	for (size_t i = 0; i < m_queue_list.size(); ++i) {
+		m_queue_list[i]->Dispatch();
+	}
+}
+
+void retro3d::EventBus::Clear( void )
+{
+	for (size_t i = 0; i < m_queue_list.size(); ++i) {
+		m_queue_list[i]->Clear();
+	}
+}
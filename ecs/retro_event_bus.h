@@ -0,0 +1,226 @@
+#ifndef RETRO_EVENT_BUS_H
+#define RETRO_EVENT_BUS_H
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+#include "retro_handle.h"
+
+#define RETRO3D_EVENT_BUS_MAX_THREADS 64 // Number of threads that can emit events at the same time without locking. Further threads share a locked overflow buffer.
+
+namespace retro3d
+{
+
+class EventBus;
+
+// Refers to a handler subscribed to an event bus.
+typedef retro3d::Handle<retro3d::EventBus> EventSubscription;
+
+// The queued events and handlers of one event type.
+class IEventQueue
+{
+public:
+	virtual ~IEventQueue( void ) {}
+
+	// Hands all queued events to the handlers in one batch.
+	virtual void Dispatch( void ) = 0;
+
+	// Drops all queued events without dispatching them.
+	virtual void Clear( void ) = 0;
+
+	virtual bool Unsubscribe(uint32_t id) = 0;
+};
+
+template < typename event_t >
+class EventQueue : public IEventQueue
+{
+public:
+	typedef std::function<void(const event_t *events, uint32_t count)> Handler;
+
+private:
+	// NOTE: Each thread appends to its own buffer, kept on its own cache line, so emitting needs no locking.
+	struct alignas(64) Buffer
+	{
+		std::vector<event_t> events;
+	};
+
+	struct Subscriber
+	{
+		Handler  fn;
+		uint32_t id; // 0 when unsubscribed, removed after the next dispatch.
+	};
+
+private:
+	Buffer                  m_buffers[RETRO3D_EVENT_BUS_MAX_THREADS];
+	std::vector<event_t>    m_overflow; // Events from threads without a buffer of their own.
+	std::mutex              m_overflow_mutex;
+	std::vector<event_t>    m_events; // The batch being dispatched.
+	std::vector<Subscriber> m_subscribers;
+
+public:
+	void Emit(const event_t &e, uint32_t thread_slot);
+	void Subscribe(const Handler &fn, uint32_t id);
+
+	void Dispatch( void ) override;
+	void Clear( void ) override;
+	bool Unsubscribe(uint32_t id) override;
+};
+
+// Delivers events of any type from producers to handlers in batches. Producers, including systems running on worker threads, append events to per-type queues during the frame, and the engine hands each queue to its handlers at defined sync points.
+// NOTE: Events of a type that has no handlers are dropped. Subscribe and Dispatch from the main thread only, never while systems are running.
+class EventBus
+{
+private:
+	typedef std::unordered_map<std::type_index, IEventQueue*> EventQueues;
+
+private:
+	EventQueues               m_queues;
+	std::vector<IEventQueue*> m_queue_list; // Same queues as m_queues, in creation order.
+	uint32_t                  m_next_id;
+
+private:
+	template < typename event_t > EventQueue<event_t> *FindQueue( void ) const;
+
+public:
+	// Construction.
+	EventBus( void );
+	~EventBus( void );
+
+	EventBus(const EventBus&) = delete;
+	EventBus &operator=(const EventBus&) = delete;
+
+	// Returns the buffer index of the calling thread. Indices are reused once their threads exit.
+	// NOTE: Threads beyond RETRO3D_EVENT_BUS_MAX_THREADS get an index with no buffer of its own and emit through the locked overflow buffer.
+	static uint32_t GetThreadSlot( void );
+
+	// Queues an event for the next dispatch. Safe to call from several threads at once. Events emitted by a handler are dispatched at the next sync point.
+	template < typename event_t > void Emit(const event_t &e);
+
+	// Calls fn with all events of the type emitted since the last dispatch, in one contiguous batch. Events from the same thread keep their order.
+	template < typename event_t > retro3d::EventSubscription Subscribe(const typename EventQueue<event_t>::Handler &fn);
+
+	// Removes a handler. Returns false if the handler has already been removed.
+	bool Unsubscribe(retro3d::EventSubscription subscription);
+
+	// Dispatches all queued events, one event type at a time in the order the types were first subscribed to.
+	void Dispatch( void );
+
+	// Drops all queued events. Handlers stay subscribed.
+	void Clear( void );
+};
+
+}
+
+template < typename event_t >
+void retro3d::EventQueue<event_t>::Emit(const event_t &e, uint32_t thread_slot)
+{
+	if (thread_slot < RETRO3D_EVENT_BUS_MAX_THREADS) {
+		m_buffers[thread_slot].events.push_back(e);
+	} else {
+		std::lock_guard<std::mutex> lock(m_overflow_mutex);
+		m_overflow.push_back(e);
+	}
+}
+
+template < typename event_t >
+void retro3d::EventQueue<event_t>::Subscribe(const typename retro3d::EventQueue<event_t>::Handler &fn, uint32_t id)
+{
+	m_subscribers.push_back(Subscriber{ fn, id });
+}
+
+template < typename event_t >
+void retro3d::EventQueue<event_t>::Dispatch( void )
+{
+	m_events.clear();
+	for (uint32_t i = 0; i < RETRO3D_EVENT_BUS_MAX_THREADS; ++i) {
+		std::vector<event_t> &events = m_buffers[i].events;
+		m_events.insert(m_events.end(), events.begin(), events.end());
+		events.clear();
+	}
+	m_events.insert(m_events.end(), m_overflow.begin(), m_overflow.end());
+	m_overflow.clear();
+
+	// NOTE: Handlers subscribed during dispatch receive events from the next dispatch. Handlers unsubscribed during dispatch are skipped.
+	const size_t subscriber_count = m_subscribers.size();
+	if (m_events.empty() == false) {
+		for (size_t i = 0; i < subscriber_count; ++i) {
+			if (m_subscribers[i].id != 0) {
+				Handler fn = m_subscribers[i].fn; // NOTE: Copied, since the handler may subscribe new handlers.
+				fn(m_events.data(), uint32_t(m_events.size()));
+			}
+		}
+	}
+
+	size_t n = 0;
+	for (size_t i = 0; i < m_subscribers.size(); ++i) {
+		if (m_subscribers[i].id != 0) {
+			m_subscribers[n++] = m_subscribers[i];
+		}
+	}
+	m_subscribers.resize(n);
+}
+
+template < typename event_t >
+void retro3d::EventQueue<event_t>::Clear( void )
+{
+	for (uint32_t i = 0; i < RETRO3D_EVENT_BUS_MAX_THREADS; ++i) {
+		m_buffers[i].events.clear();
+	}
+	m_overflow.clear();
+	m_events.clear();
+}
+
+template < typename event_t >
+bool retro3d::EventQueue<event_t>::Unsubscribe(uint32_t id)
+{
+	for (size_t i = 0; i < m_subscribers.size(); ++i) {
+		if (m_subscribers[i].id == id) {
+			m_subscribers[i].id = 0;
+			m_subscribers[i].fn = nullptr;
+			return true;
+		}
+	}
+	return false;
+}
+
+template < typename event_t >
+retro3d::EventQueue<event_t> *retro3d::EventBus::FindQueue( void ) const
+{
+	EventQueues::const_iterator i = m_queues.find(std::type_index(typeid(event_t)));
+	return i != m_queues.end() ? static_cast<EventQueue<event_t>*>(i->second) : nullptr;
+}
+
+template < typename event_t >
+void retro3d::EventBus::Emit(const event_t &e)
+{
+	EventQueue<event_t> *queue = FindQueue<event_t>();
+	if (queue != nullptr) {
+		queue->Emit(e, GetThreadSlot());
+	}
+}
+
+template < typename event_t >
+retro3d::EventSubscription retro3d::EventBus::Subscribe(const typename retro3d::EventQueue<event_t>::Handler &fn)
+{
+	EventQueue<event_t> *queue = FindQueue<event_t>();
+	uint32_t index = 0;
+	if (queue == nullptr) {
+		queue = new EventQueue<event_t>;
+		m_queues[std::type_index(typeid(event_t))] = queue;
+		index = uint32_t(m_queue_list.size());
+		m_queue_list.push_back(queue);
+	} else {
+		while (m_queue_list[index] != queue) {
+			++index;
+		}
+	}
+	const uint32_t id = m_next_id++;
+	queue->Subscribe(fn, id);
+	return retro3d::EventSubscription(index, id);
+}
+
+#endif // RETRO_EVENT_BUS_H
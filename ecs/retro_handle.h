@@ -0,0 +1,102 @@
+#ifndef RETRO_HANDLE_H
+#define RETRO_HANDLE_H
+
+#include <cstdint>
+#include <functional>
+
+namespace retro3d
+{
+
+class Entity;
+
+// Handle
+// A weak reference to an object owned by an engine, packed into 64 bits as an entity index and a generation.
+// The engine bumps the generation when the object is deleted, so a handle resolves to null once the object is gone, even if the index is reused.
+// NOTE: Entity handles use the generation of the entity index. Component handles use the generation of the entity's slot in the component pool, which is bumped whenever a component leaves it.
+template < typename type_t >
+class Handle
+{
+private:
+	uint64_t m_value; // [generation:32][index:32]. 0 means null (generations start at 1).
+
+public:
+	Handle( void );
+	Handle(uint32_t index, uint32_t generation);
+
+	// Returns the entity index the handle refers to.
+	uint32_t GetIndex( void ) const;
+
+	// Returns the generation of the entity index, or of the component slot, at the time the handle was created.
+	uint32_t GetGeneration( void ) const;
+
+	// Returns the packed handle value.
+	uint64_t GetValue( void ) const;
+
+	// Determines if the handle was never assigned an object. A non-null handle may still refer to a deleted object.
+	bool IsNull( void ) const;
+
+	bool operator==(const Handle &r) const;
+	bool operator!=(const Handle &r) const;
+};
+
+typedef retro3d::Handle<retro3d::Entity> EntityHandle;
+template < typename component_t > using ComponentHandle = retro3d::Handle<component_t>;
+
+}
+
+template < typename type_t >
+retro3d::Handle<type_t>::Handle( void ) : m_value(0)
+{}
+
+template < typename type_t >
+retro3d::Handle<type_t>::Handle(uint32_t index, uint32_t generation) : m_value((uint64_t(generation) << 32) | uint64_t(index))
+{}
+
+template < typename type_t >
+uint32_t retro3d::Handle<type_t>::GetIndex( void ) const
+{
+	return uint32_t(m_value & 0xffffffff);
+}
+
+template < typename type_t >
+uint32_t retro3d::Handle<type_t>::GetGeneration( void ) const
+{
+	return uint32_t(m_value >> 32);
+}
+
+template < typename type_t >
+uint64_t retro3d::Handle<type_t>::GetValue( void ) const
+{
+	return m_value;
+}
+
+template < typename type_t >
+bool retro3d::Handle<type_t>::IsNull( void ) const
+{
+	return m_value == 0;
+}
+
+template < typename type_t >
+bool retro3d::Handle<type_t>::operator==(const retro3d::Handle<type_t> &r) const
+{
+	return m_value == r.m_value;
+}
+
+template < typename type_t >
+bool retro3d::Handle<type_t>::operator!=(const retro3d::Handle<type_t> &r) const
+{
+	return m_value != r.m_value;
+}
+
+namespace std
+{
+
+template < typename type_t >
+struct hash< retro3d::Handle<type_t> >
+{
+	size_t operator()(const retro3d::Handle<type_t> &h) const { return std::hash<uint64_t>()(h.GetValue()); }
+};
+
+}
+
+#endif // RETRO_HANDLE_H
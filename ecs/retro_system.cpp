@@ -1,11 +1,48 @@
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#if defined(__GNUC__)
+	#include <cxxabi.h>
+#endif
 #include "retro_system.h"
 #include "../common/MiniLib/MML/mmlMath.h"
 
 retro3d::ISystem::ISystem( void ) :
 	mtlBase(this),
-	m_is_active(1), m_should_destroy(false)
+	m_engine(nullptr), m_name(nullptr), m_order(0), m_parallel_chunk_size(0),
+	m_is_active(1), m_declared_access(false), m_is_simulation(false), m_samples_input(false), m_should_destroy(false)
 {}
 
+void retro3d::ISystem::DeclareRead(uint64_t component_class_type)
+{
+	m_declared_access = true;
+	m_reads.push_back(component_class_type);
+}
+
+void retro3d::ISystem::DeclareWrite(uint64_t component_class_type)
+{
+	m_declared_access = true;
+	m_writes.push_back(component_class_type);
+}
+
+void retro3d::ISystem::SetParallelUpdate(uint32_t chunk_size)
+{
+	m_parallel_chunk_size = chunk_size;
+}
+
+void retro3d::ISystem::SetSimulation(bool is_simulation)
+{
+	m_is_simulation = is_simulation;
+}
+
+void retro3d::ISystem::SetSamplesInput(bool samples_input)
+{
+	m_samples_input = samples_input;
+}
+
 retro3d::ISystem::~ISystem( void )
 {}
 
@@ -43,3 +80,69 @@ const retro3d::Engine *retro3d::ISystem::GetEngine( void ) const
 {
 	return m_engine;
 }
+
+bool retro3d::ISystem::ConflictsWith(const retro3d::ISystem &system) const
+{
+	if (m_declared_access == false || system.m_declared_access == false) {
+		return true;
+	}
+
+	const uint64_t a_own = GetComponentClassType();
+	const uint64_t b_own = system.GetComponentClassType();
+	if (a_own == b_own) { return true; }
+
+	// NOTE: A write in one system conflicts with any access in the other.
+	for (size_t i = 0; i < m_writes.size(); ++i) {
+		const uint64_t w = m_writes[i];
+		if (w == b_own) { return true; }
+		for (size_t j = 0; j < system.m_reads.size(); ++j)  { if (w == system.m_reads[j])  { return true; } }
+		for (size_t j = 0; j < system.m_writes.size(); ++j) { if (w == system.m_writes[j]) { return true; } }
+	}
+	for (size_t i = 0; i < system.m_writes.size(); ++i) {
+		const uint64_t w = system.m_writes[i];
+		if (w == a_own) { return true; }
+		for (size_t j = 0; j < m_reads.size(); ++j) { if (w == m_reads[j]) { return true; } }
+	}
+	for (size_t j = 0; j < system.m_reads.size(); ++j) { if (a_own == system.m_reads[j]) { return true; } }
+	for (size_t j = 0; j < m_reads.size(); ++j)        { if (b_own == m_reads[j])        { return true; } }
+	return false;
+}
+
+const char *retro3d::ISystem::GetName( void ) const
+{
+	// NOTE: Names are interned and never freed, so they outlive the profiler.
+	static std::mutex names_mutex;
+	static std::unordered_map<std::type_index, std::string> *names = new std::unordered_map<std::type_index, std::string>;
+
+	const std::type_info &type = typeid(*this);
+	std::lock_guard<std::mutex> lock(names_mutex);
+	std::unordered_map<std::type_index, std::string>::iterator i = names->find(std::type_index(type));
+	if (i == names->end()) {
+		std::string name = type.name();
+#if defined(__GNUC__)
+		int status = 0;
+		char *demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+		if (status == 0 && demangled != nullptr) {
+			name = demangled;
+		}
+		std::free(demangled);
+#endif
+		i = names->insert(std::make_pair(std::type_index(type), name)).first;
+	}
+	return i->second.c_str();
+}
+
+uint32_t retro3d::ISystem::GetParallelChunkSize( void ) const
+{
+	return m_parallel_chunk_size;
+}
+
+bool retro3d::ISystem::IsSimulation( void ) const
+{
+	return m_is_simulation;
+}
+
+bool retro3d::ISystem::SamplesInput( void ) const
+{
+	return m_samples_input;
+}
@@ -2,6 +2,7 @@
 #define RETRO_SYSTEM_H
 
 #include <cstdint>
+#include <vector>
 #include "../common/MiniLib/MTL/mtlType.h"
 #include "retro_component.h"
 
@@ -15,9 +16,17 @@ class ISystem : public mtlBase
 	friend class Engine;
 
 private:
-	retro3d::Engine *m_engine;
-	int32_t          m_is_active;
-	bool             m_should_destroy;
+	retro3d::Engine       *m_engine;
+	const char            *m_name; // Cached GetName, used for profiler markers.
+	std::vector<uint64_t>  m_reads;
+	std::vector<uint64_t>  m_writes;
+	uint64_t               m_order;
+	uint32_t               m_parallel_chunk_size;
+	int32_t                m_is_active;
+	bool                   m_declared_access;
+	bool                   m_is_simulation;
+	bool                   m_samples_input;
+	bool                   m_should_destroy;
 
 protected:
 	virtual void OnSpawn( void ) = 0;
@@ -26,8 +35,25 @@ protected:
 
 	virtual void OnSpawn(retro3d::Component *c) = 0;
 	virtual void OnUpdate(retro3d::Component *c) = 0;
+	virtual void OnUpdateParallel(retro3d::Component *c) = 0;
 	virtual void OnDestroy(retro3d::Component *c) = 0;
 
+	// Declares that the system reads or writes components of the given class during its update. The system's own component class is always considered written.
+	// NOTE: Systems that declare no access at all are never run concurrently with other systems.
+	void DeclareRead(uint64_t component_class_type);
+	void DeclareWrite(uint64_t component_class_type);
+	template < typename component_t > void Reads( void )  { DeclareRead(component_t::GetClassType()); }
+	template < typename component_t > void Writes( void ) { DeclareWrite(component_t::GetClassType()); }
+
+	// Makes the engine call OnUpdateParallel on chunks of components across worker threads instead of OnUpdate on the main thread. A chunk size of 0 disables parallel updates.
+	void SetParallelUpdate(uint32_t chunk_size);
+
+	// Marks the system as part of the simulation. When the engine runs at a fixed update frequency simulation systems are updated once per fixed step, while other systems are updated once per frame.
+	void SetSimulation(bool is_simulation);
+
+	// Makes the engine sample the latest input right before the system updates instead of relying on the input read at the start of the frame. Use for latency sensitive systems, such as camera look.
+	void SetSamplesInput(bool samples_input);
+
 public:
 	ISystem( void );
 	virtual ~ISystem( void );
@@ -46,6 +72,22 @@ public:
 	const retro3d::Engine *GetEngine( void ) const;
 
 	virtual uint64_t GetComponentClassType( void ) const = 0;
+
+	// Returns a readable name of the system, used for profiler markers. Defaults to the demangled class name.
+	// NOTE: The returned string must live for the rest of the process, since profiler markers store it as a pointer.
+	virtual const char *GetName( void ) const;
+
+	// Determines if the system may not run concurrently with the given system based on declared component access.
+	bool ConflictsWith(const ISystem &system) const;
+
+	// Returns the number of components per chunk when updating in parallel. 0 if the system updates serially.
+	uint32_t GetParallelChunkSize( void ) const;
+
+	// Determines if the system is updated once per fixed simulation step.
+	bool IsSimulation( void ) const;
+
+	// Determines if the engine samples input right before the system updates.
+	bool SamplesInput( void ) const;
 };
 
 template < typename component_t >
@@ -58,10 +100,12 @@ protected:
 
 	void         OnSpawn(retro3d::Component *c) override;
 	void         OnUpdate(retro3d::Component *c) override;
+	void         OnUpdateParallel(retro3d::Component *c) override;
 	void         OnDestroy(retro3d::Component *c) override;
 
 	virtual void OnSpawn(component_t &c);
 	virtual void OnUpdate(component_t &c);
+	virtual void OnUpdateParallel(component_t &c); // Called from worker threads, defaults to OnUpdate. Only touch the component and declared data.
 	virtual void OnDestroy(component_t &c);
 
 public:
@@ -99,6 +143,12 @@ void retro3d::System<component_t>::OnUpdate(retro3d::Component *c)
 	OnUpdate(*mtlCast<component_t>(c));
 }
 
+template < typename component_t >
+void retro3d::System<component_t>::OnUpdateParallel(retro3d::Component *c)
+{
+	OnUpdateParallel(*mtlCast<component_t>(c));
+}
+
 template < typename component_t >
 void retro3d::System<component_t>::OnDestroy(retro3d::Component *c)
 {
@@ -113,6 +163,12 @@ template < typename component_t >
 void retro3d::System<component_t>::OnUpdate(component_t&)
 {}
 
+template < typename component_t >
+void retro3d::System<component_t>::OnUpdateParallel(component_t &c)
+{
+	OnUpdate(c);
+}
+
 template < typename component_t >
 void retro3d::System<component_t>::OnDestroy(component_t&)
 {}
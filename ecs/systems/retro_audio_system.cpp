@@ -31,4 +31,7 @@ void retro3d::AudioSystem::OnUpdate( void )
 }
 
 retro3d::AudioSystem::AudioSystem( void ) : mtlInherit(this), m_sound_stage()
-{}
+{
+	// NOTE: The camera may be attached to a transform.
+	Reads<retro3d::TransformComponent>();
+}
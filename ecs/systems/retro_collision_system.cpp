@@ -1,5 +1,6 @@
 #include "retro_collision_system.h"
 #include "../../ecs/components/retro_physics_component.h"
+#include "../../ecs/components/retro_transform_component.h"
 #include "../../retro3d.h"
 
 void retro3d::CollisionSystem::OnSpawn(retro3d::ColliderComponent &c)
@@ -44,8 +45,10 @@ void retro3d::CollisionSystem::OnUpdate( void )
 		retro3d::Collider::Contact c_info;
 		if (c.a.collider->IsColliding(*c.b.collider, &c_info) == true) {
 			ResolveContactA(c, c_info);
+			EmitContactA(c, c_info);
 			SwapCollisionInfo(c, c_info); // Collider A and B have switched place, and collsion normal is flipped.
 			ResolveContactA(c, c_info);
+			EmitContactA(c, c_info);
 		}
 		c_iter = c_iter->GetNext();
 	}
@@ -77,8 +80,18 @@ void retro3d::CollisionSystem::ResolveContactA(const retro3d::ColliderTree<retro
 	}
 }
 
+void retro3d::CollisionSystem::EmitContactA(const retro3d::ColliderTree<retro3d::Entity>::Contact &contact_pair, const retro3d::Collider::Contact &contact_info)
+{
+	retro3d::Engine *engine = GetEngine();
+	engine->GetEvents()->Emit(retro3d::CollisionEvent{ engine->GetHandle(*contact_pair.a.user_data), engine->GetHandle(*contact_pair.b.user_data), contact_info.point, contact_info.normal, contact_info.depth });
+}
+
 retro3d::CollisionSystem::CollisionSystem( void ) : mtlInherit(this)
-{}
+{
+	SetSimulation(true);
+	Writes<retro3d::TransformComponent>(); // NOTE: Contacts are resolved by moving transforms.
+	Writes<retro3d::PhysicsComponent>();
+}
 
 retro3d::Entity *retro3d::CollisionSystem::CastRay(const retro3d::Ray &world_ray, uint64_t filter_flags, retro3d::Ray::Contact *contact_info) const
 {
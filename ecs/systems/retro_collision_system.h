@@ -1,6 +1,7 @@
 #ifndef RETRO_COLLISION_SYSTEM_H
 #define RETRO_COLLISION_SYSTEM_H
 
+#include "../retro_handle.h"
 #include "../retro_system.h"
 #include "../components/retro_collider_component.h"
 #include "../../physics/retro_collider_tree.h"
@@ -9,6 +10,16 @@
 namespace retro3d
 {
 
+// Emitted through the engine event bus for every pair of overlapping colliders, once for each entity of the pair. The engine passes the events on to Entity::OnCollision and Component::OnCollision.
+struct CollisionEvent
+{
+	retro3d::EntityHandle entity;
+	retro3d::EntityHandle other;
+	mmlVector<3>          point;
+	mmlVector<3>          normal; // Direction in which 'entity' is pushed out of 'other'.
+	float                 depth;
+};
+
 retro_system(CollisionSystem, retro3d::ColliderComponent)
 {
 private:
@@ -22,6 +33,7 @@ protected:
 
 private:
 	void ResolveContactA(const retro3d::ColliderTree<retro3d::Entity>::Contact &contact_pair, const retro3d::Collider::Contact &contact_info) const;
+	void EmitContactA(const retro3d::ColliderTree<retro3d::Entity>::Contact &contact_pair, const retro3d::Collider::Contact &contact_info);
 
 public:
 	CollisionSystem( void );
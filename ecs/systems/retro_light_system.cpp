@@ -1,4 +1,5 @@
 #include "retro_light_system.h"
+#include "../components/retro_transform_component.h"
 #include "../../retro3d.h"
 
 void retro3d::LightSystem::OnSpawn(retro3d::LightComponent &c)
@@ -25,6 +26,7 @@ void retro3d::LightSystem::OnDestroy(retro3d::LightComponent &c)
 
 retro3d::LightSystem::LightSystem( void ) : mtlInherit(this)
 {
+	Reads<retro3d::TransformComponent>();
 	if (m_light_tree.IsCheckingContacts() == true) {
 		m_light_tree.ToggleContactCheck();
 	}
@@ -1,5 +1,6 @@
 #include "retro_render_system.h"
 #include "../retro_entity.h"
+#include "../components/retro_transform_component.h"
 #include "../../backend/null_render_device.h"
 #include "../../backend/t3d_render_device.h"
 
@@ -13,6 +14,8 @@ void retro3d::RenderSystem::OnUpdate(retro3d::RenderComponent &c)
 {
 	// NOTE: Immediate rendering of potentially visible RenderComponents.
 
+	if (GetEngine()->IsHeadless() == true) { return; }
+
 	if (c.GetModel().IsNull() == false) {
 		const mmlMatrix<4,4>   world_transform = c.GetTransformMatrix();
 		const retro3d::AABB    world_aabb      = c.GetModel()->aabb.ApplyTransform(world_transform);
@@ -34,6 +37,8 @@ void retro3d::RenderSystem::OnUpdate( void )
 {
 	// NOTE: Deferred rendering of RenderComponents, omitting objects outside of view frustum via BVH.
 
+	if (GetEngine()->IsHeadless() == true) { return; }
+
 	m_potentially_visible_items = m_potentially_visible_items_counter;
 	m_potentially_visible_items_counter = 0;
 
@@ -44,6 +49,13 @@ void retro3d::RenderSystem::OnUpdate( void )
 
 	m_view_frustum = r->GetViewFrustum();
 
+	if (GetEngine()->IsProfilerOverlayVisible() == true) {
+		const std::vector<retro3d::Profiler::Summary> &summary = retro3d::Profiler::Instance().GetSummary();
+		for (size_t i = 0; i < summary.size(); ++i) {
+			r->RenderText(std::string(summary[i].depth * 2, ' ') + summary[i].name + ": ").RenderText(summary[i].average_ms).RenderText(" ms\n");
+		}
+	}
+
 //	mtlList<retro3d::RenderComponent*> pvs;
 
 //	m_view_hierarchy.Contains(m_view_frustum, ~uint64_t(0), &pvs);
@@ -57,11 +69,17 @@ void retro3d::RenderSystem::OnUpdate( void )
 //		i = i->GetNext();
 //	}
 
-	r->FinishRender();
+	{
+		RETRO3D_PROFILE_SCOPE("FinishRender");
+		r->FinishRender();
+	}
 }
 
 retro3d::RenderSystem::RenderSystem( void ) : mtlInherit(this), m_view_hierarchy(), m_light_hierarchy(), m_view_frustum(), m_render_items(0), m_potentially_visible_items(0), m_potentially_visible_items_counter(0)
-{}
+{
+	// NOTE: The render device and camera are only used by this system during updates, so only component access needs declaring.
+	Reads<retro3d::TransformComponent>();
+}
 
 uint32_t retro3d::RenderSystem::GetRenderItemCount( void ) const
 {
@@ -35,4 +35,6 @@ void retro3d::SceneSystem::OnDestroy(retro3d::SceneComponent &scene)
 }
 
 retro3d::SceneSystem::SceneSystem( void ) : mtlInherit(this), m_current_scene(nullptr), m_num_scenes(0)
-{}
+{
+	Writes<retro3d::SceneComponent>();
+}
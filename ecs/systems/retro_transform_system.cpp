@@ -1,4 +1,14 @@
 #include "retro_transform_system.h"
 
+void retro3d::TransformSystem::OnUpdate(retro3d::TransformComponent &c)
+{
+	// NOTE: Only out of date matrices are recomputed, and a transform brings its parents up to date before itself.
+	c.GetTransform()->GetFinalMatrix();
+}
+
 retro3d::TransformSystem::TransformSystem( void ) : mtlInherit(this)
-{}
+{
+	SetSimulation(true);
+	Writes<retro3d::TransformComponent>();
+	SetParallelUpdate(256); // NOTE: Transforms sharing a parent may compute the parent's final matrix concurrently, which the transform cache permits.
+}
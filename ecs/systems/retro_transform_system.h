@@ -7,8 +7,12 @@
 namespace retro3d
 {
 
+// Brings the cached final matrices of all transforms up to date once per update so that later readers do not have to.
 retro_system(TransformSystem, retro3d::TransformComponent)
 {
+protected:
+	void OnUpdate(retro3d::TransformComponent &c) override;
+
 public:
 	TransformSystem( void );
 };
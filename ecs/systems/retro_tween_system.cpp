@@ -0,0 +1,35 @@
+#include "retro_tween_system.h"
+
+retro3d::TweenSystem::TweenSystem(const retro3d::Engine &engine) : m_engine(&engine), m_arrays(), m_array_list()
+{}
+
+retro3d::TweenSystem::~TweenSystem( void )
+{
+	for (size_t i = 0; i < m_array_list.size(); ++i) {
+		delete m_array_list[i];
+	}
+}
+
+void retro3d::TweenSystem::Update( void )
+{
+	const retro3d::Time now[3] = { m_engine->RealTime(), m_engine->SimulationTime(), m_engine->GameTime() }; // Indexed by retro3d::TimerType.
+	for (size_t i = 0; i < m_array_list.size(); ++i) {
+		m_array_list[i]->Update(now);
+	}
+}
+
+void retro3d::TweenSystem::Clear( void )
+{
+	for (size_t i = 0; i < m_array_list.size(); ++i) {
+		m_array_list[i]->Clear();
+	}
+}
+
+uint32_t retro3d::TweenSystem::GetCount( void ) const
+{
+	uint32_t count = 0;
+	for (size_t i = 0; i < m_array_list.size(); ++i) {
+		count += m_array_list[i]->GetCount();
+	}
+	return count;
+}
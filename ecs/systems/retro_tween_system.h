@@ -0,0 +1,261 @@
+#ifndef RETRO_TWEEN_SYSTEM_H
+#define RETRO_TWEEN_SYSTEM_H
+
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+#include "../../retro3d.h"
+#include "../retro_handle.h"
+#include "../entities/retro_tween.h"
+
+namespace retro3d
+{
+
+// The tweens of one value type.
+class ITweenArray
+{
+public:
+	virtual ~ITweenArray( void ) {}
+
+	// Advances all tweens. 'now' holds the current time of each retro3d::TimerType.
+	virtual void Update(const retro3d::Time *now) = 0;
+
+	// Stops all tweens cold.
+	virtual void Clear( void ) = 0;
+
+	virtual uint32_t GetCount( void ) const = 0;
+};
+
+template < typename type_t >
+class TweenArray : public ITweenArray
+{
+private:
+	struct Entry
+	{
+		type_t               *target;
+		type_t                current; // The value last applied to the target.
+		type_t                from;
+		type_t                to;
+		retro3d::Time         start;
+		retro3d::Time         duration;
+		uint32_t              id;
+		retro3d::ITween::Mode mode;
+		retro3d::TimerType    timer_type;
+	};
+
+	enum { NO_SLOT = 0xffffffff };
+
+private:
+	std::vector<Entry>    m_tweens; // Contiguous, unordered.
+	std::vector<uint32_t> m_slots; // Tween ID -> index in m_tweens, or NO_SLOT.
+	std::vector<uint32_t> m_generations; // Tween ID -> generation, bumped when the tween is removed.
+	std::vector<uint32_t> m_free_ids;
+
+private:
+	void     Remove(uint32_t index);
+	uint32_t Find(retro3d::Handle< retro3d::TweenArray<type_t> > h) const;
+
+public:
+	retro3d::Handle< retro3d::TweenArray<type_t> > Add(type_t &from, const type_t &to, retro3d::ITween::Mode mode, retro3d::Time start, retro3d::Time duration, retro3d::TimerType timer_type);
+	bool Cancel(retro3d::Handle< retro3d::TweenArray<type_t> > h);
+	bool Finish(retro3d::Handle< retro3d::TweenArray<type_t> > h);
+	bool IsTweening(retro3d::Handle< retro3d::TweenArray<type_t> > h) const;
+
+	void     Update(const retro3d::Time *now) override;
+	void     Clear( void ) override;
+	uint32_t GetCount( void ) const override;
+};
+
+template < typename type_t > using TweenHandle = retro3d::Handle< retro3d::TweenArray<type_t> >;
+
+// Advances all tweens of the engine once per frame, one tight loop per value type, without an entity per tween.
+// NOTE: Tweens behave like retro3d::Tween, but are owned by the engine. The target must outlive the tween, or the tween must be cancelled first.
+class TweenSystem
+{
+private:
+	typedef std::unordered_map<std::type_index, ITweenArray*> TweenArrays;
+
+private:
+	const retro3d::Engine     *m_engine;
+	TweenArrays                m_arrays;
+	std::vector<ITweenArray*>  m_array_list; // Same arrays as m_arrays, in creation order.
+
+private:
+	template < typename type_t > TweenArray<type_t>       *GetArray( void );
+	template < typename type_t > const TweenArray<type_t> *FindArray( void ) const;
+
+public:
+	// Construction.
+	explicit TweenSystem(const retro3d::Engine &engine);
+	~TweenSystem( void );
+
+	TweenSystem(const TweenSystem&) = delete;
+	TweenSystem &operator=(const TweenSystem&) = delete;
+
+	// Starts tweening the value 'from' towards 'to' over the given duration. The tween is removed once it reaches its destination.
+	template < typename type_t > retro3d::TweenHandle<type_t> Add(type_t &from, const type_t &to, retro3d::ITween::Mode mode, retro3d::Time duration, retro3d::TimerType timer_type = retro3d::TIMER_GAME);
+
+	// Stops the tweening process cold. Returns false if the tween has already been removed.
+	template < typename type_t > bool Cancel(retro3d::TweenHandle<type_t> h);
+
+	// Forces the tween to finish. Returns false if the tween has already been removed.
+	template < typename type_t > bool Finish(retro3d::TweenHandle<type_t> h);
+
+	// Determines if the tween is still running.
+	template < typename type_t > bool IsTweening(retro3d::TweenHandle<type_t> h) const;
+
+	// Advances all tweens to the current engine time.
+	void Update( void );
+
+	// Stops all tweens cold.
+	void Clear( void );
+
+	// Returns the number of running tweens.
+	uint32_t GetCount( void ) const;
+};
+
+}
+
+template < typename type_t >
+void retro3d::TweenArray<type_t>::Remove(uint32_t index)
+{
+	const uint32_t id = m_tweens[index].id;
+	m_slots[id] = uint32_t(NO_SLOT);
+	if (++m_generations[id] == 0) {
+		m_generations[id] = 1;
+	}
+	m_free_ids.push_back(id);
+	if (index + 1 < m_tweens.size()) {
+		m_tweens[index] = m_tweens.back();
+		m_slots[m_tweens[index].id] = index;
+	}
+	m_tweens.pop_back();
+}
+
+template < typename type_t >
+uint32_t retro3d::TweenArray<type_t>::Find(retro3d::Handle< retro3d::TweenArray<type_t> > h) const
+{
+	const uint32_t id = h.GetIndex();
+	return (id < m_slots.size() && m_generations[id] == h.GetGeneration()) ? m_slots[id] : uint32_t(NO_SLOT);
+}
+
+template < typename type_t >
+retro3d::Handle< retro3d::TweenArray<type_t> > retro3d::TweenArray<type_t>::Add(type_t &from, const type_t &to, retro3d::ITween::Mode mode, retro3d::Time start, retro3d::Time duration, retro3d::TimerType timer_type)
+{
+	uint32_t id;
+	if (m_free_ids.empty() == false) {
+		id = m_free_ids.back();
+		m_free_ids.pop_back();
+	} else {
+		id = uint32_t(m_slots.size());
+		m_slots.push_back(uint32_t(NO_SLOT));
+		m_generations.push_back(1);
+	}
+	m_slots[id] = uint32_t(m_tweens.size());
+	m_tweens.push_back(Entry{ &from, from, from, to, start, duration, id, mode, timer_type });
+	return retro3d::Handle< retro3d::TweenArray<type_t> >(id, m_generations[id]);
+}
+
+template < typename type_t >
+bool retro3d::TweenArray<type_t>::Cancel(retro3d::Handle< retro3d::TweenArray<type_t> > h)
+{
+	const uint32_t index = Find(h);
+	if (index == uint32_t(NO_SLOT)) { return false; }
+	Remove(index);
+	return true;
+}
+
+template < typename type_t >
+bool retro3d::TweenArray<type_t>::Finish(retro3d::Handle< retro3d::TweenArray<type_t> > h)
+{
+	const uint32_t index = Find(h);
+	if (index == uint32_t(NO_SLOT)) { return false; }
+	Entry &t = m_tweens[index];
+	retro3d::FinishTween(t.mode, *t.target, t.current, t.to);
+	Remove(index);
+	return true;
+}
+
+template < typename type_t >
+bool retro3d::TweenArray<type_t>::IsTweening(retro3d::Handle< retro3d::TweenArray<type_t> > h) const
+{
+	return Find(h) != uint32_t(NO_SLOT);
+}
+
+template < typename type_t >
+void retro3d::TweenArray<type_t>::Update(const retro3d::Time *now)
+{
+	// NOTE: A finished tween is replaced by the last tween, so the index only advances past tweens that are still running.
+	for (uint32_t i = 0; i < m_tweens.size();) {
+		Entry &t = m_tweens[i];
+		const float d = t.duration.IsZero() == false ? mmlClamp(0.0f, float(((now[t.timer_type] - t.start) / t.duration).GetFloatSeconds()), 1.0f) : 1.0f;
+		retro3d::ApplyTween(t.mode, *t.target, t.current, t.from, t.to, d);
+		if (d >= 1.0f) {
+			Remove(i);
+		} else {
+			++i;
+		}
+	}
+}
+
+template < typename type_t >
+void retro3d::TweenArray<type_t>::Clear( void )
+{
+	while (m_tweens.empty() == false) {
+		Remove(uint32_t(m_tweens.size() - 1));
+	}
+}
+
+template < typename type_t >
+uint32_t retro3d::TweenArray<type_t>::GetCount( void ) const
+{
+	return uint32_t(m_tweens.size());
+}
+
+template < typename type_t >
+retro3d::TweenArray<type_t> *retro3d::TweenSystem::GetArray( void )
+{
+	TweenArrays::iterator i = m_arrays.find(std::type_index(typeid(type_t)));
+	if (i != m_arrays.end()) {
+		return static_cast<TweenArray<type_t>*>(i->second);
+	}
+	TweenArray<type_t> *a = new TweenArray<type_t>;
+	m_arrays[std::type_index(typeid(type_t))] = a;
+	m_array_list.push_back(a);
+	return a;
+}
+
+template < typename type_t >
+const retro3d::TweenArray<type_t> *retro3d::TweenSystem::FindArray( void ) const
+{
+	TweenArrays::const_iterator i = m_arrays.find(std::type_index(typeid(type_t)));
+	return i != m_arrays.end() ? static_cast<const TweenArray<type_t>*>(i->second) : nullptr;
+}
+
+template < typename type_t >
+retro3d::TweenHandle<type_t> retro3d::TweenSystem::Add(type_t &from, const type_t &to, retro3d::ITween::Mode mode, retro3d::Time duration, retro3d::TimerType timer_type)
+{
+	return GetArray<type_t>()->Add(from, to, mode, m_engine->Time(timer_type), duration, timer_type);
+}
+
+template < typename type_t >
+bool retro3d::TweenSystem::Cancel(retro3d::TweenHandle<type_t> h)
+{
+	return GetArray<type_t>()->Cancel(h);
+}
+
+template < typename type_t >
+bool retro3d::TweenSystem::Finish(retro3d::TweenHandle<type_t> h)
+{
+	return GetArray<type_t>()->Finish(h);
+}
+
+template < typename type_t >
+bool retro3d::TweenSystem::IsTweening(retro3d::TweenHandle<type_t> h) const
+{
+	const TweenArray<type_t> *a = FindArray<type_t>();
+	return a != nullptr && a->IsTweening(h);
+}
+
+#endif // RETRO_TWEEN_SYSTEM_H
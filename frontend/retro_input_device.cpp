@@ -1,23 +1,63 @@
 #include "retro_input_device.h"
+#include <atomic>
+#include "../common/MiniLib/MML/mmlMath.h"
 
-void retro3d::InputMap::Bind(const mtlChars &action, uint64_t input_code)
+namespace
 {
-	*m_binds.CreateEntry(action) = input_code;
+
+std::atomic<uint32_t> g_next_input_map_id(1); // 0 is reserved for null handles.
+
+}
+
+retro3d::InputMap::InputMap( void ) : m_id(g_next_input_map_id++)
+{}
+
+retro3d::InputAction retro3d::InputMap::Bind(const mtlChars &action, uint64_t input_code)
+{
+	const retro3d::InputAction h = GetAction(action);
+	m_binds[h.GetIndex()] = input_code;
+	m_bound[h.GetIndex()] = true;
+	return h;
 }
 
 void retro3d::InputMap::Unbind(const mtlChars &action)
 {
-	m_binds.RemoveEntry(action);
+	const uint32_t *i = m_actions.GetEntry(action);
+	if (i != nullptr) {
+		m_bound[*i] = false;
+	}
 }
 
 void retro3d::InputMap::UnbindAll( void )
 {
-	m_binds.RemoveAll();
+	for (size_t i = 0; i < m_bound.size(); ++i) {
+		m_bound[i] = false;
+	}
+}
+
+retro3d::InputAction retro3d::InputMap::GetAction(const mtlChars &action)
+{
+	const uint32_t *i = m_actions.GetEntry(action);
+	if (i == nullptr) {
+		const uint32_t index = uint32_t(m_binds.size());
+		*m_actions.CreateEntry(action) = index;
+		m_binds.push_back(0);
+		m_bound.push_back(false);
+		return retro3d::InputAction(index, m_id);
+	}
+	return retro3d::InputAction(*i, m_id);
 }
 
 const uint64_t *retro3d::InputMap::GetInput(const mtlChars &action) const
 {
-	return m_binds.GetEntry(action);
+	const uint32_t *i = m_actions.GetEntry(action);
+	return (i != nullptr && m_bound[*i] == true) ? &m_binds[*i] : nullptr;
+}
+
+const uint64_t *retro3d::InputMap::GetInput(retro3d::InputAction action) const
+{
+	const uint32_t i = action.GetIndex();
+	return (action.GetGeneration() == m_id && i < m_binds.size() && m_bound[i] == true) ? &m_binds[i] : nullptr;
 }
 
 void retro3d::InputDevice::CreateStateTable(uint64_t size)
@@ -28,7 +68,48 @@ void retro3d::InputDevice::CreateStateTable(uint64_t size)
 	}
 }
 
-retro3d::InputDevice::InputDevice( void ) : m_binds(nullptr)
+void retro3d::InputDevice::BeginEvents( void )
+{
+	m_update_event = m_event_count;
+}
+
+void retro3d::InputDevice::PushEvent(uint64_t input, float activation, uint64_t time_ms)
+{
+	m_events[m_event_count % RETRO3D_INPUT_EVENT_CAPACITY] = Event{ input, activation, time_ms };
+	++m_event_count;
+}
+
+void retro3d::InputDevice::ApplyEvents( void )
+{
+	// NOTE: A press and release between two updates is invisible to the polled state, but the event still wakes the input for one update.
+	for (uint32_t i = 0; i < GetEventCount(); ++i) {
+		const Event &e = GetEvent(i);
+		if (e.activation != 0.0f && e.input < uint64_t(m_state.GetSize())) {
+			m_state[int(e.input)].awoken = true;
+		}
+	}
+}
+
+void retro3d::InputDevice::BeginSample( void )
+{
+	m_sample_event = m_event_count;
+}
+
+void retro3d::InputDevice::ApplySampledEvents( void )
+{
+	const uint64_t oldest = m_event_count > RETRO3D_INPUT_EVENT_CAPACITY ? m_event_count - RETRO3D_INPUT_EVENT_CAPACITY : 0;
+	for (uint64_t i = mmlMax(m_sample_event, oldest); i < m_event_count; ++i) {
+		const Event &e = m_events[i % RETRO3D_INPUT_EVENT_CAPACITY];
+		if (e.input < uint64_t(m_state.GetSize())) {
+			Input &s = m_state[int(e.input)];
+			s.delta += e.activation - s.activation;
+			s.activation = e.activation;
+			s.awoken = s.awoken || e.activation != 0.0f;
+		}
+	}
+}
+
+retro3d::InputDevice::InputDevice( void ) : m_binds(nullptr), m_event_count(0), m_update_event(0), m_sample_event(0)
 {}
 
 retro3d::InputDevice::~InputDevice( void )
@@ -46,3 +127,20 @@ retro3d::InputDevice::Input retro3d::InputDevice::GetState(const mtlChars &actio
 	const uint64_t *lookup = m_binds != nullptr ? m_binds->GetInput(action) : nullptr;
 	return lookup != nullptr ? m_state[*lookup] : Input{ 0.0f, 0.0f, 0.0, false };
 }
+
+retro3d::InputDevice::Input retro3d::InputDevice::GetState(retro3d::InputAction action) const
+{
+	const uint64_t *lookup = m_binds != nullptr ? m_binds->GetInput(action) : nullptr;
+	return lookup != nullptr ? m_state[*lookup] : Input{ 0.0f, 0.0f, 0.0, false };
+}
+
+uint32_t retro3d::InputDevice::GetEventCount( void ) const
+{
+	const uint64_t count = m_event_count - m_update_event;
+	return uint32_t(count < RETRO3D_INPUT_EVENT_CAPACITY ? count : RETRO3D_INPUT_EVENT_CAPACITY);
+}
+
+const retro3d::InputDevice::Event &retro3d::InputDevice::GetEvent(uint32_t index) const
+{
+	return m_events[(m_event_count - GetEventCount() + index) % RETRO3D_INPUT_EVENT_CAPACITY];
+}
@@ -2,25 +2,47 @@
 #define RETRO_INPUT_DEVICE_H
 
 #include <cstdint>
+#include <vector>
 #include "retro_device.h"
 #include "../common/MiniLib/MTL/mtlArray.h"
 #include "../common/MiniLib/MTL/mtlStringMap.h"
 #include "../api/tiny3d/tiny_system.h"
 #include "../common/retro_time.h"
+#include "../ecs/retro_handle.h"
+
+#define RETRO3D_INPUT_EVENT_CAPACITY 256 // Number of input events kept before overwriting the oldest.
 
 namespace retro3d
 {
 
+class InputMap;
+
+// Refers to an action of an input map without having to look it up by name. Remains valid when the action is unbound and bound again.
+// NOTE: The generation of the handle is the id of the map that created it, so the handle resolves to null on any other map, except on copies of the map.
+typedef retro3d::Handle<retro3d::InputMap> InputAction;
+
 class InputMap
 {
 private:
-	mtlStringMap<uint64_t> m_binds;
+	mtlStringMap<uint32_t> m_actions; // Action name -> index in m_binds. Actions are never removed, so indices stay valid.
+	std::vector<uint64_t>  m_binds; // Input code per action.
+	std::vector<bool>      m_bound; // Determines if the action is bound to an input.
+	uint32_t               m_id; // Unique per constructed map, stored in the generation of the handles it hands out.
 
 public:
-	void Bind(const mtlChars &action, uint64_t input_code);
+	InputMap( void );
+
+	// Binds the action to the input and returns the handle of the action.
+	retro3d::InputAction Bind(const mtlChars &action, uint64_t input_code);
 	void Unbind(const mtlChars &action);
 	void UnbindAll( void );
+
+	// Returns the handle of the action, creating an unbound action if it does not exist. Look up handles once and use them for frequent queries.
+	retro3d::InputAction GetAction(const mtlChars &action);
+
+	// Returns the input bound to the action, or null if the action is unbound.
 	const uint64_t *GetInput(const mtlChars &action) const;
+	const uint64_t *GetInput(retro3d::InputAction action) const;
 };
 
 class InputDevice : public retro3d::Device
@@ -31,19 +53,45 @@ public:
 		float  activation; // usually 0.0 - 1.0, although an axis would probably give -1.0 - 1.0
 		float  delta;      // the difference in activation since last update
 		double time;       // the amount of time the state has been non-zero or zero (changes reset timer)
-		bool   awoken;     // 1 on the frame when inactive input becomes active, 0 all other times
+		bool   awoken;     // 1 on the frame when inactive input becomes active, 0 all other times. Also 1 if the input was both activated and deactivated since the last update.
+	};
+
+	// A change in the activation of an input.
+	struct Event
+	{
+		uint64_t input;
+		float    activation;
+		uint64_t time_ms; // Program time at which the change happened, which may be between updates.
 	};
 
 private:
 	const InputMap *m_binds;
+	Event           m_events[RETRO3D_INPUT_EVENT_CAPACITY]; // Ring buffer, m_events[m_event_count % capacity] is the next event to be overwritten.
+	uint64_t        m_event_count; // Total number of events recorded.
+	uint64_t        m_update_event; // Value of m_event_count at the start of the last update.
+	uint64_t        m_sample_event; // Value of m_event_count at the start of the last sample.
 
 protected:
 	mtlArray<Input> m_state; // fixed length, number of inputs on the device
-	mtlArray<Input> m_delta; // all changes in input, in order (replaces m_state?)
 
 protected:
 	void CreateStateTable(uint64_t size);
 
+	// Marks the start of an update. Events recorded after this belong to the update.
+	void BeginEvents( void );
+
+	// Records a change in the activation of an input.
+	void PushEvent(uint64_t input, float activation, uint64_t time_ms);
+
+	// Sets 'awoken' for inputs that were activated during the update, even if they are no longer active. Call after updating m_state.
+	void ApplyEvents( void );
+
+	// Marks the start of a sample. Events recorded after this belong to the sample, as well as the current update.
+	void BeginSample( void );
+
+	// Applies the events recorded during the sample to m_state.
+	void ApplySampledEvents( void );
+
 public:
 	InputDevice( void );
 	virtual ~InputDevice( void );
@@ -60,8 +108,18 @@ public:
 	virtual bool     IsMouseCursorVisible( void ) const = 0;
 	virtual void     Update( void ) = 0;
 
+	// Reads input that arrived since the last update or sample without starting a new update. Activations and deltas are brought up to date, while timers are left for the next update.
+	virtual void     Sample( void ) = 0;
+
 	void SetInputMap(const retro3d::InputMap *binds);
 	Input GetState(const mtlChars &action) const;
+	Input GetState(retro3d::InputAction action) const;
+
+	// Returns the number of input events recorded during the last update, at most RETRO3D_INPUT_EVENT_CAPACITY.
+	uint32_t GetEventCount( void ) const;
+
+	// Returns an event recorded during the last update, in the order they happened.
+	const Event &GetEvent(uint32_t index) const;
 };
 
 
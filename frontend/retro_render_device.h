@@ -37,6 +37,31 @@ public:
 		LightMode_Lightmap        // Fullbright + lightmap
 	};
 
+	// Statistics about the work submitted to the renderer during a frame.
+	struct FrameStats
+	{
+		uint32_t jobs_3d;         // Number of queued 3D jobs.
+		uint32_t jobs_2d;         // Number of queued 2D jobs.
+		uint32_t jobs_dropped;    // Number of jobs (or text) dropped because a queue or arena was full.
+		uint32_t text_bytes;      // Number of characters written to the text arena.
+		uint32_t bytes_submitted; // Total number of bytes written to job queues and arenas.
+		uint32_t text_runs_blit;  // Number of text jobs drawn from pre-rasterized text runs.
+		uint32_t tris_accepted;   // Number of triangles that did not need clipping.
+		uint32_t tris_clipped;    // Number of triangles clipped against the near plane or guard band.
+		uint32_t sprites;         // Number of batched sprites that survived culling.
+	};
+
+	// NOTE: A batch of camera-facing quads stored as parallel arrays. The arrays are not copied, and need to remain valid until FinishRender.
+	struct SpriteBatch
+	{
+		const mmlVector<3>     *positions; // World space centers.
+		const mmlVector<2>     *sizes;     // World space widths and heights.
+		const mmlVector<4>     *uv_rects;  // Texture coordinates as (u0, v0, u1, v1). Null maps the full texture.
+		const mmlVector<3>     *colors;    // Vertex colors. Null is white.
+		const retro3d::Texture *texture;   // Null renders untextured quads.
+		uint32_t                count;
+	};
+
 public:
 	virtual ~RenderDevice( void );
 
@@ -55,6 +80,7 @@ public:
 	virtual void RenderDisplayModel(const retro3d::DisplayModel &model, const mmlMatrix<4,4> &obj_to_world, LightMode light_mode, RenderMode render_mode = RenderMode_Polygons) = 0;
 	virtual void RenderSpritePlane(const retro3d::Model &sprite_plane, const mmlMatrix<4,4> &obj_to_world, LightMode light_mode, RenderMode render_mode = RenderMode_Polygons) = 0;
 	virtual void RenderSpritePlane(const retro3d::Model &sprite_plane, const mmlMatrix<4,4> *obj_to_world, LightMode light_mode, RenderMode render_mode = RenderMode_Polygons) = 0;
+	virtual void RenderSprites(const SpriteBatch &batch, RenderMode render_mode = RenderMode_Polygons) = 0;
 	virtual void RenderLight(const retro3d::Light &light) = 0;
 	virtual void RenderAABB(const retro3d::AABB &aabb, const mmlMatrix<4,4> &obj_to_world, const mmlVector<3> &color = mmlVector<3>(0.0, 1.0, 0.0), bool world_axis_aligned = true) = 0;
 	virtual void RenderAABB(const retro3d::AABB &aabb, const mmlMatrix<4,4> *obj_to_world, const mmlVector<3> &color = mmlVector<3>(0.0, 1.0, 0.0), bool world_axis_aligned = true) = 0;
@@ -82,6 +108,7 @@ public:
 	virtual float GetVerticalFieldOfView( void ) const = 0;
 	virtual void  SetHorizontalFieldOfView(float hori_fov) = 0;
 	virtual retro3d::Frustum GetViewFrustum( void ) const = 0;
+	virtual FrameStats GetFrameStats( void ) const = 0; // Returns the statistics of the last finished frame.
 
 	virtual void Debug_RenderTriangle(const retro3d::Vertex &a, const retro3d::Vertex &b, const retro3d::Vertex &c, const mmlMatrix<4,4> &obj_to_world, const mmlMatrix<4,4> &world_to_view, const retro3d::Texture *texture, LightMode light_mode) = 0;
 };
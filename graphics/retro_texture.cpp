@@ -13,18 +13,43 @@ void retro3d::Texture::CreateErrorTexture( void )
 void retro3d::Texture::BuildRefs( void )
 {
 	tiny3d::Texture *t = &m_mip_data[0];
+	Swizzle         *s = &m_swizzle_data[0];
 	for (tiny3d::UInt i = 0; i < RETRO3D_MIP_COUNT; ++i) {
 		m_mip_refs[i] = t;
+		m_swizzle_refs[i] = m_layout == Layout_Morton ? s : nullptr;
 		if (i < RETRO3D_MIP_COUNT - 1 && t[1].GetWidth() > 0) {
 			++t;
+			++s;
 		}
 	}
 }
 
-retro3d::Texture::Texture( void )
+void retro3d::Texture::BuildSwizzle(tiny3d::UInt level, const tiny3d::Image &img)
+{
+	// NOTE: Dimensions are powers of two, so wrapping can be done by masking.
+	Swizzle &s = m_swizzle_data[level];
+	s.dim_mask_x = img.GetWidth() - 1;
+	s.dim_mask_y = img.GetHeight() - 1;
+	s.square_bits = 0;
+	while ((tiny3d::UInt(2) << s.square_bits) <= mmlMin(img.GetWidth(), img.GetHeight())) {
+		++s.square_bits;
+	}
+	s.texels.Create(int(img.GetWidth() * img.GetHeight()));
+	for (tiny3d::UInt y = 0; y < img.GetHeight(); ++y) {
+		for (tiny3d::UInt x = 0; x < img.GetWidth(); ++x) {
+			s.texels[int(SwizzleIndex(s, x, y))] = img.GetColor({ x, y });
+		}
+	}
+}
+
+retro3d::Texture::Texture( void ) : m_layout(Layout_Linear)
 {
 	for (tiny3d::UInt i = 0; i < RETRO3D_MIP_COUNT; ++i) {
 		m_mip_refs[i] = nullptr;
+		m_swizzle_refs[i] = nullptr;
+		m_swizzle_data[i].dim_mask_x = 0;
+		m_swizzle_data[i].dim_mask_y = 0;
+		m_swizzle_data[i].square_bits = 0;
 	}
 }
 
@@ -33,15 +58,17 @@ retro3d::Texture::Texture(const retro3d::Texture &mips) : Texture()
 	Copy(mips);
 }
 
-retro3d::Texture::Texture(const tiny3d::Image &img) : Texture()
+retro3d::Texture::Texture(const tiny3d::Image &img, retro3d::Texture::Layout layout) : Texture()
 {
-	FromImage(img);
+	FromImage(img, layout);
 }
 
-bool retro3d::Texture::FromImage(const tiny3d::Image &img)
+bool retro3d::Texture::FromImage(const tiny3d::Image &img, retro3d::Texture::Layout layout)
 {
 	Destroy();
 
+	m_layout = layout;
+
 	tiny3d::Image a_img = img;
 	tiny3d::Image b_img;
 	tiny3d::Image *a = &a_img;
@@ -54,6 +81,10 @@ bool retro3d::Texture::FromImage(const tiny3d::Image &img)
 			return false;
 		}
 
+		if (m_layout == Layout_Morton) {
+			BuildSwizzle(i, *a);
+		}
+
 		if (i < RETRO3D_MIP_COUNT - 1) {
 			tiny3d::UInt w = a->GetWidth() >> 1;
 			tiny3d::UInt h = a->GetHeight() >> 1;
@@ -90,8 +121,18 @@ bool retro3d::Texture::FromImage(const tiny3d::Image &img)
 void retro3d::Texture::Copy(const retro3d::Texture &mips)
 {
 	if (this == &mips) { return; }
+	m_layout = mips.m_layout;
 	for (tiny3d::UInt i = 0; i < RETRO3D_MIP_COUNT; ++i) {
 		m_mip_data[i].Copy(mips.m_mip_data[i]);
+		const Swizzle &src = mips.m_swizzle_data[i];
+		Swizzle       &dst = m_swizzle_data[i];
+		dst.dim_mask_x = src.dim_mask_x;
+		dst.dim_mask_y = src.dim_mask_y;
+		dst.square_bits = src.square_bits;
+		dst.texels.Create(src.texels.GetSize());
+		for (int t = 0; t < src.texels.GetSize(); ++t) {
+			dst.texels[t] = src.texels[t];
+		}
 	}
 	BuildRefs();
 }
@@ -101,7 +142,13 @@ void retro3d::Texture::Destroy( void )
 	for (tiny3d::UInt i = 0; i < RETRO3D_MIP_COUNT; ++i) {
 		m_mip_data[i].Destroy();
 		m_mip_refs[i] = nullptr;
+		m_swizzle_data[i].texels.Free();
+		m_swizzle_data[i].dim_mask_x = 0;
+		m_swizzle_data[i].dim_mask_y = 0;
+		m_swizzle_data[i].square_bits = 0;
+		m_swizzle_refs[i] = nullptr;
 	}
+	m_layout = Layout_Linear;
 }
 
 void retro3d::Texture::SetBlendMode1(tiny3d::Color::BlendMode blend_mode)
@@ -160,3 +207,8 @@ const tiny3d::Texture *retro3d::Texture::GetLowestQuality( void ) const
 {
 	return m_mip_refs[RETRO3D_MIP_COUNT - 1];
 }
+
+retro3d::Texture::Layout retro3d::Texture::GetLayout( void ) const
+{
+	return m_layout;
+}
@@ -3,6 +3,7 @@
 
 #include "../api/tiny3d/tiny_texture.h"
 #include "../api/tiny3d/tiny_image.h"
+#include "../common/MiniLib/MTL/mtlArray.h"
 #include "../common/retro_assets.h"
 
 // 256x256
@@ -18,21 +19,51 @@ namespace retro3d
 
 class Texture : public retro3d::Asset<Texture>
 {
+public:
+	// The memory layout of the texels in each mip level.
+	// NOTE: Layout_Morton is groundwork. The Tiny3d rasterizer samples its own row-major textures, so nothing in the engine reads the Morton copy yet, and it doubles the texel memory of the texture. Only GetTexel and Sample read it.
+	enum Layout
+	{
+		Layout_Linear, // Row-major. Only the Tiny3d mip data is stored.
+		Layout_Morton  // Row-major Tiny3d mip data plus a Z-order (Morton) copy used for cache coherent sampling regardless of the direction the texture is traversed in.
+	};
+
+private:
+	struct Swizzle
+	{
+		mtlArray<tiny3d::Color> texels;
+		tiny3d::UInt            dim_mask_x;
+		tiny3d::UInt            dim_mask_y;
+		tiny3d::UInt            square_bits; // Log2 of the smaller dimension. Only this many low bits of x and y are interleaved.
+	};
+
 private:
 	tiny3d::Texture  m_mip_data[RETRO3D_MIP_COUNT];
 	tiny3d::Texture *m_mip_refs[RETRO3D_MIP_COUNT]; // TODO: Decouple from Tiny3d (for compatibility with other API:s) - This must instead be an index array
+	Swizzle          m_swizzle_data[RETRO3D_MIP_COUNT];
+	Swizzle         *m_swizzle_refs[RETRO3D_MIP_COUNT];
+	Layout           m_layout;
 
 private:
 	void Delete( void );
 	void CreateErrorTexture( void );
 	void BuildRefs( void );
+	void BuildSwizzle(tiny3d::UInt level, const tiny3d::Image &img);
+
+	// Returns the index of a wrapped texel in the Morton ordered copy.
+	// NOTE: Non-square levels are stored as a row of Morton ordered squares along the longer axis, so the copy is exactly as large as the level.
+	static inline uint32_t SwizzleIndex(const Swizzle &s, tiny3d::UInt x, tiny3d::UInt y);
+
+public:
+	// Interleaves the bits of x and y (x in even bits, y in odd bits).
+	static inline uint32_t EncodeMorton(uint32_t x, uint32_t y);
 
 public:
 			  Texture( void );
 			  Texture(const retro3d::Texture &mips);
-	explicit  Texture(const tiny3d::Image &img);
+	explicit  Texture(const tiny3d::Image &img, Layout layout = Layout_Linear);
 
-	bool FromImage(const tiny3d::Image &img);
+	bool FromImage(const tiny3d::Image &img, Layout layout = Layout_Linear);
 	void Copy(const Texture &mips);
 	void Destroy( void );
 	void SetBlendMode1(tiny3d::Color::BlendMode blend_mode);
@@ -48,10 +79,59 @@ public:
 	const tiny3d::Texture *GetHighestQuality( void ) const;
 	const tiny3d::Texture *GetLowestQuality( void ) const;
 
+	// Returns the layout the texture was built with.
+	Layout GetLayout( void ) const;
+
+	// Returns a texel from the Morton ordered copy of the given mip level. Coordinates wrap around. Only valid for Layout_Morton.
+	inline tiny3d::Color GetTexel(tiny3d::UInt level, tiny3d::UInt x, tiny3d::UInt y) const;
+
+	// Returns the nearest texel at normalized texture coordinates u, v (wrapping) from the Morton ordered copy of the given mip level. Only valid for Layout_Morton.
+	inline tiny3d::Color Sample(tiny3d::UInt level, float u, float v) const;
+
 	static constexpr uint32_t MaxDimension( void ) { return tiny3d::Texture::MaxDimension(); }
 	static constexpr uint32_t MinDimension( void ) { return tiny3d::Texture::MinDimension(); }
 };
 
 }
 
+uint32_t retro3d::Texture::EncodeMorton(uint32_t x, uint32_t y)
+{
+	x &= 0x0000ffff;
+	x = (x | (x << 8)) & 0x00ff00ff;
+	x = (x | (x << 4)) & 0x0f0f0f0f;
+	x = (x | (x << 2)) & 0x33333333;
+	x = (x | (x << 1)) & 0x55555555;
+	y &= 0x0000ffff;
+	y = (y | (y << 8)) & 0x00ff00ff;
+	y = (y | (y << 4)) & 0x0f0f0f0f;
+	y = (y | (y << 2)) & 0x33333333;
+	y = (y | (y << 1)) & 0x55555555;
+	return x | (y << 1);
+}
+
+uint32_t retro3d::Texture::SwizzleIndex(const retro3d::Texture::Swizzle &s, tiny3d::UInt x, tiny3d::UInt y)
+{
+	x &= s.dim_mask_x;
+	y &= s.dim_mask_y;
+	const uint32_t square_mask = (uint32_t(1) << s.square_bits) - 1;
+	// NOTE: At most one of x and y has bits above the square mask.
+	return EncodeMorton(uint32_t(x) & square_mask, uint32_t(y) & square_mask) | ((uint32_t(x | y) >> s.square_bits) << (s.square_bits * 2));
+}
+
+tiny3d::Color retro3d::Texture::GetTexel(tiny3d::UInt level, tiny3d::UInt x, tiny3d::UInt y) const
+{
+	const Swizzle *s = m_swizzle_refs[level < RETRO3D_MIP_COUNT ? level : RETRO3D_MIP_COUNT - 1];
+	if (s == nullptr) { return tiny3d::Color{ 0, 0, 0, tiny3d::Color::Transparent }; }
+	return s->texels[int(SwizzleIndex(*s, x, y))];
+}
+
+tiny3d::Color retro3d::Texture::Sample(tiny3d::UInt level, float u, float v) const
+{
+	const Swizzle *s = m_swizzle_refs[level < RETRO3D_MIP_COUNT ? level : RETRO3D_MIP_COUNT - 1];
+	if (s == nullptr) { return tiny3d::Color{ 0, 0, 0, tiny3d::Color::Transparent }; }
+	const tiny3d::UInt x = tiny3d::UInt(int32_t(u * float(s->dim_mask_x + 1)));
+	const tiny3d::UInt y = tiny3d::UInt(int32_t(v * float(s->dim_mask_y + 1)));
+	return s->texels[int(SwizzleIndex(*s, x, y))];
+}
+
 #endif // RETRO_TEXTURE_H
@@ -1,6 +1,9 @@
 #include <iostream>
+#include <algorithm>
+#include <cmath>
 #include "common/MiniLib/MGL/mglCollision.h"
 #include "retro3d.h"
+#include "common/retro_assert.h"
 #include "common/retro_defs.h"
 #include "common/retro_factory.h"
 #include "backend/null_render_device.h"
@@ -11,10 +14,32 @@
 #include "ecs/systems/retro_light_system.h"
 #include "ecs/systems/retro_render_system.h"
 #include "ecs/systems/retro_transform_system.h"
+#include "ecs/systems/retro_tween_system.h"
 #include "ecs/systems/retro_audio_system.h"
 
+namespace
+{
+
+// NOTE: Asset libraries are process-wide unless RETRO3D_THREAD_LOCAL_ASSETS is defined, so engines constructed on different threads must not create base content at the same time.
+std::recursive_mutex g_base_content_mutex;
+
+// Returns a copy of the texture with a reference count of its own.
+mtlShared<retro3d::Texture> CopyTexture(const mtlShared<retro3d::Texture> &t)
+{
+	mtlShared<retro3d::Texture> c;
+	if (t.IsNull() == false) {
+		c.New();
+		*c.GetShared() = *t.GetShared();
+	}
+	return c;
+}
+
+}
+
 void retro3d::Engine::CreateBaseModels( void )
 {
+	std::lock_guard<std::recursive_mutex> lock(g_base_content_mutex);
+
 	std::cout << "Creating base content...";
 
 	if (retro3d::Texture::Library.Exists("Default.Texture") == false) {
@@ -503,10 +528,10 @@ void retro3d::Engine::SetupTimers( void )
 
 void retro3d::Engine::AddRequiredSystems( void )
 {
+	AddSystem<retro3d::TransformSystem>(); // NOTE: Added first so that final matrices are up to date before the other systems read them.
 	AddSystem<retro3d::CollisionSystem>();
 	AddSystem<retro3d::LightSystem>();
 	AddSystem<retro3d::RenderSystem>();
-	AddSystem<retro3d::TransformSystem>();
 	AddSystem<retro3d::AudioSystem>();
 }
 
@@ -521,11 +546,13 @@ void retro3d::Engine::Reset( void )
 	m_quit = false;
 	m_frame = 0;
 	m_delta_time = m_min_delta_time.GetFloatSeconds();
+	m_fixed_accumulator = 0.0;
 
 	SetupTimers();
 
 	m_frame_start_time = m_real_timer.GetScaledTime();
 	m_frame_time = m_min_delta_time;
+	m_pacer.Reset();
 }
 
 void retro3d::Engine::UpdateDevices( void )
@@ -535,78 +562,205 @@ void retro3d::Engine::UpdateDevices( void )
 
 void retro3d::Engine::InitSystems( void )
 {
-	Systems pending = m_systems_pending_init; // copy the pending list in order to handle pending objects that create new pending objects
-	m_systems_pending_init.clear(); // all currently pending objects will be initialized via 'pending', so clear this map
+	Systems pending;
+	pending.swap(m_systems_pending_init); // systems added while initializing 'pending' stay pending until next frame
 
 	// Initialize pending systems
 	for (Systems::iterator i = pending.begin(); i != pending.end(); ++i) {
 		i->second->OnSpawn();
 		m_systems[i->second->GetInstanceType()] = i->second;
+		m_system_schedule_dirty = true;
 	}
 }
 
 void retro3d::Engine::InitComponents( void )
 {
-	Components pending = m_components_pending_init; // copy the pending list in order to handle pending objects that create new pending objects
-	m_components_pending_init.clear(); // all currently pending objects will be initialized via 'pending', so clear this map
+	// NOTE: Components added while initializing are appended to m_pending_pools and the pools' pending lists, and are initialized next frame.
+	m_spawned_pools.clear();
+	m_spawned_pools.swap(m_pending_pools);
+	m_spawned_components.clear();
+	m_spawned_first.resize(m_spawned_pools.size() + 1);
 
 	// Hand over pending components to main component list
-	for (Components::iterator i = pending.begin(); i != pending.end(); ++i) {
-		for (ComponentClass::iterator j = i->second.begin(); j != i->second.end(); ++j) {
-			m_components[i->first][j->first] = j->second;
-		}
+	for (size_t i = 0; i < m_spawned_pools.size(); ++i) {
+		m_spawned_first[i] = m_spawned_components.size();
+		m_spawned_pools[i]->CommitPending(m_spawned_components);
 	}
+	m_spawned_first[m_spawned_pools.size()] = m_spawned_components.size();
 
 	// Initialize pending components
-	for (Components::iterator i = pending.begin(); i != pending.end(); ++i) {
-		for (ComponentClass::iterator j = i->second.begin(); j != i->second.end(); ++j) {
-			j->second->OnSpawn();
-		}
+	for (size_t i = 0; i < m_spawned_components.size(); ++i) {
+		m_spawned_components[i]->OnSpawn();
 	}
 
-	// Call systems
+	// Call systems, one contiguous batch per component type
 	for (Systems::iterator system = m_systems.begin(); system != m_systems.end(); ++system) {
-		Components::iterator component_class = pending.find(system->second->GetComponentClassType());
-		if (component_class != pending.end()) {
-			for (ComponentClass::iterator component = component_class->second.begin(); component != component_class->second.end(); ++component) {
-				system->second->OnSpawn(component->second);
+		for (size_t i = 0; i < m_spawned_pools.size(); ++i) {
+			if (m_spawned_pools[i]->GetClassType() == system->second->GetComponentClassType()) {
+				for (size_t j = m_spawned_first[i]; j < m_spawned_first[i + 1]; ++j) {
+					system->second->OnSpawn(m_spawned_components[j]);
+				}
 			}
 		}
 	}
 }
 
+void retro3d::Engine::RecordLastTransforms( void )
+{
+	// NOTE: Done in a pass of its own before anything can move, so that the last transform is the same for every transform regardless of update order.
+	const IComponentPool *pool = FindComponentPool(retro3d::TransformComponent::GetClassType());
+	if (pool != nullptr) {
+		for (uint32_t i = 0; i < pool->GetSize(); ++i) {
+			static_cast<retro3d::TransformComponent*>((*pool)[i])->RecordLastTransform();
+		}
+	}
+}
+
 void retro3d::Engine::TickComponents( void )
 {
+	RepartitionComponents();
+
 	// Update components
-	for (Components::iterator i = m_components.begin(); i != m_components.end(); ++i) {
-		for (ComponentClass::iterator j = i->second.begin(); j != i->second.end(); ++j) {
-			if (j->second->IsActive() == true) {
-				j->second->OnUpdate();
+	for (size_t i = 0; i < m_component_pools.size(); ++i) {
+		const IComponentPool &pool = *m_component_pools[i];
+		for (uint32_t j = 0; j < pool.GetActiveCount(); ++j) {
+			retro3d::Component *c = pool[j];
+			if (c->IsActive() == true) {
+				c->OnUpdate();
 			}
 		}
 	}
 }
 
-void retro3d::Engine::TickSystems( void )
+void retro3d::Engine::BuildSystemSchedule( void )
 {
-	// Let the system iterate through all components of requested type
-	for (Systems::iterator system = m_systems.begin(); system != m_systems.end(); ++system) {
-		if (system->second->IsActive() == true) {
-			Components::iterator component_class = m_components.find(system->second->GetComponentClassType());
-			if (component_class != m_components.end()) {
-				for (ComponentClass::iterator component = component_class->second.begin(); component != component_class->second.end(); ++component) {
-					if (component->second->IsActive() == true) {
-						system->second->OnUpdate(component->second);
-					}
+	// NOTE: Systems are scheduled in the order they were added. A system is placed in the first group after every earlier system it conflicts with.
+	std::vector<ISystem*> systems;
+	for (Systems::iterator i = m_systems.begin(); i != m_systems.end(); ++i) {
+		systems.push_back(i->second);
+	}
+	std::sort(systems.begin(), systems.end(), [](const ISystem *a, const ISystem *b) { return a->m_order < b->m_order; });
+
+	m_system_schedule.clear();
+	std::vector<size_t> group(systems.size(), 0);
+	size_t min_group = 0;
+	for (size_t i = 0; i < systems.size(); ++i) {
+		size_t g = min_group;
+		if (systems[i]->GetParallelChunkSize() > 0) {
+			// NOTE: Systems that update in parallel use all workers, so they get a group of their own.
+			g = mmlMax(g, m_system_schedule.size());
+			min_group = g + 1;
+		} else {
+			for (size_t j = 0; j < i; ++j) {
+				if (group[j] >= g && systems[i]->ConflictsWith(*systems[j]) == true) {
+					g = group[j] + 1;
+				}
+			}
+		}
+		group[i] = g;
+		if (g >= m_system_schedule.size()) {
+			m_system_schedule.resize(g + 1);
+		}
+		m_system_schedule[g].push_back(systems[i]);
+	}
+	m_system_schedule_dirty = false;
+}
+
+void retro3d::Engine::UpdateSystem(retro3d::ISystem *system, retro3d::Engine::SystemPass pass)
+{
+	if (system->IsActive() == false) { return; }
+	if (pass == SystemPass_Simulation && system->IsSimulation() == false) { return; }
+	if (pass == SystemPass_Presentation && system->IsSimulation() == true) { return; }
+
+	const IComponentPool *pool = FindComponentPool(system->GetComponentClassType());
+	if (pool == nullptr) { return; }
+
+	RETRO3D_PROFILE_SCOPE(system->m_name);
+
+	const uint32_t chunk_size = system->GetParallelChunkSize();
+	if (chunk_size > 0) {
+		const uint32_t num_chunks = (pool->GetActiveCount() + chunk_size - 1) / chunk_size;
+		m_workers.Execute(num_chunks, [system, pool, chunk_size](uint32_t chunk) {
+			const uint32_t end = mmlMin(pool->GetActiveCount(), (chunk + 1) * chunk_size);
+			for (uint32_t i = chunk * chunk_size; i < end; ++i) {
+				retro3d::Component *c = (*pool)[i];
+				if (c->IsActive() == true) {
+					system->OnUpdateParallel(c);
 				}
-				system->second->OnUpdate();
 			}
+		});
+	} else {
+		for (uint32_t i = 0; i < pool->GetActiveCount(); ++i) {
+			retro3d::Component *c = (*pool)[i];
+			if (c->IsActive() == true) {
+				system->OnUpdate(c);
+			}
+		}
+	}
+	system->OnUpdate();
+}
+
+void retro3d::Engine::TickSystems(retro3d::Engine::SystemPass pass)
+{
+	if (m_system_schedule_dirty == true) {
+		BuildSystemSchedule();
+	}
+	RepartitionComponents();
+
+	// Let the systems iterate through all components of requested type, concurrently if they do not conflict
+	for (size_t i = 0; i < m_system_schedule.size(); ++i) {
+		std::vector<ISystem*> &group = m_system_schedule[i];
+		for (size_t j = 0; j < group.size(); ++j) {
+			const bool in_pass = pass == SystemPass_All || (pass == SystemPass_Simulation) == group[j]->IsSimulation();
+			if (group[j]->SamplesInput() == true && group[j]->IsActive() == true && in_pass == true) {
+				// NOTE: Sampled on the main thread between groups, so no system reads input while it changes.
+				RETRO3D_PROFILE_SCOPE("SampleInput");
+				m_input->Sample();
+				break;
+			}
+		}
+		if (group.size() == 1) {
+			UpdateSystem(group[0], pass);
+		} else {
+			m_workers.Execute(uint32_t(group.size()), [this, &group, pass](uint32_t j) {
+				UpdateSystem(group[j], pass);
+			});
 		}
 	}
 }
 
+void retro3d::Engine::TickFixedSteps( void )
+{
+	const double step = 1.0 / m_fixed_update_hz;
+	const double frame_delta_time = m_delta_time;
+
+	m_fixed_accumulator += frame_delta_time;
+	for (uint32_t i = 0; i < m_max_fixed_steps && m_fixed_accumulator >= step; ++i) {
+		RETRO3D_PROFILE_SCOPE("Step");
+		m_delta_time = step;
+		RecordLastTransforms();
+		TickComponents();
+		TickSystems(SystemPass_Simulation);
+		TickEntities();
+		DispatchEvents();
+		m_fixed_accumulator -= step;
+	}
+	if (m_fixed_accumulator >= step) {
+		// The simulation can not keep up. Drop the time that was not simulated rather than falling further behind every frame.
+		m_fixed_accumulator = std::fmod(m_fixed_accumulator, step);
+	}
+	m_delta_time = frame_delta_time;
+	m_interpolation_alpha = m_fixed_accumulator / step;
+
+	TickSystems(SystemPass_Presentation);
+}
+
 void retro3d::Engine::TickEntities( void )
 {
+	if (m_late_input_sampling == true) {
+		RETRO3D_PROFILE_SCOPE("SampleInput");
+		m_input->Sample();
+	}
 	mtlItem<retro3d::Entity*> *i = m_entities.GetFirst();
 	while (i != nullptr) {
 		i->GetItem()->OnUpdate();
@@ -622,6 +776,7 @@ void retro3d::Engine::DestroySystems( void )
 			i->second->OnDestroy();
 			delete i->second;
 			i = m_systems.erase(i);
+			m_system_schedule_dirty = true;
 		} else {
 			++i;
 		}
@@ -666,36 +821,62 @@ void retro3d::Engine::DestroyComponents( void )
 		}
 	}*/
 
-	ComponentIters pending;
-
-	// 1) Construct a list containing components to be removed and tell components they are about to be removed.
-	for (Components::iterator i = m_components.begin(); i != m_components.end(); ++i) {
-		for (ComponentClass::iterator j = i->second.begin(); j != i->second.end(); ++j) {
-			if (j->second->IsDestroyed() == true) {
-				pending[i->first][j->first] = j;
-				// 1.a) Tell components they are about to be removed.
-				j->second->OnDestroy();
+	// NOTE: Only components and entities marked for destruction are visited. Entities marked for destruction while destroying components are destroyed next frame.
+	m_dying_entities.clear();
+	m_dying_entities.swap(m_destroyed_entities);
+
+	// 0) Components of destroyed entities are destroyed with the entity.
+	for (size_t i = 0; i < m_dying_entities.size(); ++i) {
+		const uint32_t entity_index = m_dying_entities[i]->m_index;
+		for (size_t j = 0; j < m_component_pools.size(); ++j) {
+			retro3d::Component *c = m_component_pools[j]->Get(entity_index);
+			if (c != nullptr) {
+				m_component_pools[j]->AddDestroyed(c);
 			}
 		}
 	}
 
-	// 2) Tell systems that component is to be removed.
+	// NOTE: Destroyed components are gathered per pool, m_dying_components[m_dying_first[i]] to m_dying_components[m_dying_first[i + 1]] belong to m_component_pools[i].
+	const size_t num_pools = m_component_pools.size();
+	m_dying_components.clear();
+	m_dying_first.resize(num_pools + 1);
+
+	// 1) Construct a list containing components to be removed.
+	for (size_t i = 0; i < num_pools; ++i) {
+		m_dying_first[i] = m_dying_components.size();
+		m_component_pools[i]->CollectDestroyed(m_dying_components);
+	}
+	m_dying_first[num_pools] = m_dying_components.size();
+
+	// 1.a) Pending components of destroyed entities can never be initialized since the entity is deleted this frame.
+	for (size_t i = 0; i < m_pending_pools.size(); ++i) {
+		m_pending_pools[i]->PurgePending();
+	}
+
+	// 1.b) Tell components they are about to be removed.
+	for (size_t i = 0; i < m_dying_components.size(); ++i) {
+		m_dying_components[i]->OnDestroy();
+	}
+
+	// 2) Tell systems that component is to be removed, one contiguous batch per component type.
 	for (Systems::iterator system = m_systems.begin(); system != m_systems.end(); ++system) {
-		ComponentIters::iterator component_class = pending.find(system->second->GetComponentClassType());
-		if (component_class != pending.end()) {
-			for (ComponentClassIters::iterator component = component_class->second.begin(); component != component_class->second.end(); ++component) {
-				system->second->OnDestroy(component->second->second);
+		for (size_t i = 0; i < num_pools; ++i) {
+			if (m_component_pools[i]->GetClassType() == system->second->GetComponentClassType()) {
+				for (size_t j = m_dying_first[i]; j < m_dying_first[i + 1]; ++j) {
+					system->second->OnDestroy(m_dying_components[j]);
+				}
 			}
 		}
 	}
 
 	// 3) Delete component memory and remove component from component list.
-	for (ComponentIters::iterator i = pending.begin(); i != pending.end(); ++i) {
-		for (ComponentClassIters::iterator j = i->second.begin(); j != i->second.end(); ++j) {
-			// 3.a) Delete component memory.
-			delete j->second->second;
-			// 3.b) Remove component from component list.
-			m_components[i->first].erase(j->second);
+	for (size_t i = 0; i < num_pools; ++i) {
+		IComponentPool *pool = m_component_pools[i];
+		for (size_t j = m_dying_first[i]; j < m_dying_first[i + 1]; ++j) {
+			// 3.a) Remove component from component list.
+			pool->Remove(m_dying_components[j]->m_object->m_index);
+			// 3.b) Delete component memory.
+			pool->Delete(m_dying_components[j]);
 		}
 	}
 }
@@ -703,15 +884,14 @@ void retro3d::Engine::DestroyComponents( void )
 void retro3d::Engine::DestroyEntities( void )
 {
 	// Delete and remove destroyed objects
-	for (mtlItem< Entity* > *i = m_entities.GetFirst(); i != nullptr;) {
-		if (i->GetItem()->IsDestroyed() == true) {
-			i->GetItem()->OnDestroy();
-			delete i->GetItem();
-			i = i->Remove();
-		} else {
-			i = i->GetNext();
-		}
+	for (size_t i = 0; i < m_dying_entities.size(); ++i) {
+		retro3d::Entity *e = m_dying_entities[i];
+		e->OnDestroy();
+		m_free_entity_indices.push_back(e->m_index);
+		UnregisterEntity(e);
+		delete e;
 	}
+	m_dying_entities.clear();
 }
 
 void retro3d::Engine::DetectTermination( void )
@@ -721,7 +901,7 @@ void retro3d::Engine::DetectTermination( void )
 		std::cout << "No entities - ";
 	}
 
-	if (m_components_pending_init.size() <= 0 && m_components.size() <= 0) {
+	if (m_components.size() <= 0) { // NOTE: A pool is created the first time a component of its type is added.
 		m_quit = true;
 		std::cout << "No components - ";
 	}
@@ -742,9 +922,11 @@ void retro3d::Engine::TickTime( void )
 
 	const retro3d::Time now = m_real_timer.GetScaledTime();
 	m_frame_time = now - m_frame_start_time;
-	if (m_frame_time < m_min_delta_time) {
-		m_input->Sleep(m_min_delta_time - m_frame_time);
-	} else if (m_frame_time > m_max_delta_time) {
+	{
+		RETRO3D_PROFILE_SCOPE("Pace");
+		m_pacer.Wait(); // NOTE: Never waits with an unlimited update frequency.
+	}
+	if (m_frame_time > m_max_delta_time) {
 		// The game does not achieve minimal acceptable target frame rate. Rather than making the time delta larger (as we might break stuff like physics), we slow down execution of the game.
 		// We make sure not to update the timer as that will push the current unscaled time delta to the accumulated
 		m_sim_timer.SetTimeScale(m_max_delta_time / m_frame_time, false);
@@ -753,51 +935,115 @@ void retro3d::Engine::TickTime( void )
 	m_real_time = m_real_timer.UpdateTimer();
 	m_sim_time = m_sim_timer.UpdateTimer();
 
-	retro3d::Time game_now = m_game_timer.UpdateTimer();
+	const retro3d::Time game_now = m_game_timer.UpdateTimer();
 	m_delta_time = (game_now - m_game_time).GetFloatSeconds();
 	m_game_time = game_now;
 
-	auto i = m_entities.GetFirst();
-	while (i != nullptr) {
-		retro3d::Entity *e = i->GetItem();
+	// NOTE: Entity time is derived from the engine game time when requested, see Entity::GameLifeTime and Entity::DeltaTime.
 
-		game_now = e->m_game_timer.UpdateTimer();
-		e->m_delta_time = (game_now - e->m_game_time).GetFloatSeconds();
-		e->m_game_time = e->m_game_timer.UpdateTimer();
+	m_frame_start_time = m_real_time; // Do not use 'now' since that is before sleeping
+}
 
-		i = i->GetNext();
-	}
+void retro3d::Engine::DispatchEvents( void )
+{
+	RETRO3D_PROFILE_SCOPE("Events");
+	m_events.Dispatch();
+}
 
-	m_frame_start_time = m_real_time; // Do not use 'now' since that is before sleeping
+void retro3d::Engine::DeliverCollisions(const retro3d::CollisionEvent *events, uint32_t count)
+{
+	// NOTE: Callbacks may destroy entities, so handles are resolved one event at a time.
+	for (uint32_t i = 0; i < count; ++i) {
+		retro3d::Entity *e = Resolve(events[i].entity);
+		retro3d::Entity *other = Resolve(events[i].other);
+		if (e == nullptr || other == nullptr || e->IsDestroyed() == true || other->IsDestroyed() == true) { continue; }
+
+		e->OnCollision(*other);
+		for (size_t j = 0; j < m_component_pools.size(); ++j) {
+			retro3d::Component *c = m_component_pools[j]->Get(e->m_index);
+			if (c != nullptr && c->IsActive() == true) {
+				c->OnCollision(*other);
+			}
+		}
+	}
 }
 
 void retro3d::Engine::Tick( void )
 {
-	m_rand.GetUint();
-
-	m_input->Update();
+	// NOTE: The profiler frame is process-wide, so headless engines, which may run several at a time on different threads, do not drive it. Their markers are still recorded per thread.
+	retro3d::Profiler &profiler = retro3d::Profiler::Instance();
+	if (m_headless == false) {
+		profiler.BeginFrame(m_frame);
+	}
 
-	InitSystems();
+	m_rand.GetUint();
 
-	InitComponents();
+	{
+		RETRO3D_PROFILE_SCOPE("Input");
+		m_input->Update();
+	}
 
-	TickComponents();
+	{
+		RETRO3D_PROFILE_SCOPE("Init");
+		InitSystems();
+		InitComponents();
+	}
 
-	TickSystems();
+	{
+		RETRO3D_PROFILE_SCOPE("Timers");
+		m_timer_wheels[retro3d::TIMER_REAL].Advance(m_real_time);
+		m_timer_wheels[retro3d::TIMER_SIM].Advance(m_sim_time);
+		m_timer_wheels[retro3d::TIMER_GAME].Advance(m_game_time);
+	}
 
-	TickEntities();
+	if (m_fixed_update_hz == 0) {
+		{
+			RETRO3D_PROFILE_SCOPE("Components");
+			RecordLastTransforms();
+			TickComponents();
+		}
+		{
+			RETRO3D_PROFILE_SCOPE("Systems");
+			TickSystems(SystemPass_All);
+		}
+		{
+			RETRO3D_PROFILE_SCOPE("Entities");
+			TickEntities();
+		}
+	} else {
+		RETRO3D_PROFILE_SCOPE("FixedSteps");
+		TickFixedSteps();
+	}
 
-	DestroySystems();
+	DispatchEvents();
 
-	DestroyComponents();
+	{
+		RETRO3D_PROFILE_SCOPE("Tweens");
+		m_tweens->Update();
+	}
 
-	DestroyEntities();
+	{
+		RETRO3D_PROFILE_SCOPE("Destroy");
+		DestroySystems();
+		DestroyComponents();
+		DestroyEntities();
+	}
 
-	m_video->Display();
+	if (m_headless == false) {
+		RETRO3D_PROFILE_SCOPE("Display");
+		m_video->Display();
+	}
 
 	DetectTermination();
 
-	TickTime();
+	{
+		RETRO3D_PROFILE_SCOPE("Time");
+		TickTime();
+	}
+
+	if (m_headless == false) {
+		profiler.EndFrame();
+	}
 
 	++m_frame;
 }
@@ -810,19 +1056,28 @@ void retro3d::Engine::Cleanup( void )
 		delete system->second;
 	}
 	m_systems.clear();
+	m_system_schedule.clear();
+	m_system_schedule_dirty = true;
 
-	for (Components::iterator i = m_components_pending_init.begin(); i != m_components_pending_init.end(); ++i) {
-		for (ComponentClass::iterator j = i->second.begin(); j != i->second.end(); ++j) {
-			delete j->second;
-		}
+	m_tweens->Clear();
+	m_events.Clear();
+	for (uint32_t i = 0; i < 3; ++i) {
+		m_timer_wheels[i].Reset(retro3d::Time(0));
 	}
-	m_components_pending_init.clear();
 
-	for (Components::iterator i = m_components.begin(); i != m_components.end(); ++i) {
-		for (ComponentClass::iterator j = i->second.begin(); j != i->second.end(); ++j) {
-			delete j->second;
+	for (size_t i = 0; i < m_pending_pools.size(); ++i) {
+		m_pending_pools[i]->DeletePending();
+	}
+	m_pending_pools.clear();
+
+	for (size_t i = 0; i < m_component_pools.size(); ++i) {
+		IComponentPool *pool = m_component_pools[i];
+		for (uint32_t j = 0; j < pool->GetSize(); ++j) {
+			pool->Delete((*pool)[j]);
 		}
+		delete pool;
 	}
+	m_component_pools.clear();
 	m_components.clear();
 
 	for (mtlItem< Entity* > *i = m_entities.GetFirst(); i != nullptr;) {
@@ -830,6 +1085,158 @@ void retro3d::Engine::Cleanup( void )
 		i = i->GetNext();
 	}
 	m_entities.RemoveAll();
+	m_entity_table.clear();
+	m_entity_generations.clear();
+	m_entity_uuids.clear();
+	m_entity_tags.clear();
+	m_entity_bits.clear();
+	for (uint32_t i = 0; i < 64; ++i) {
+		m_filter_bits[i].clear();
+	}
+	m_destroyed_entities.clear();
+	m_dying_entities.clear();
+	m_free_entity_indices.clear();
+	m_entity_index_count = 0;
+}
+
+void retro3d::Engine::RegisterEntity(retro3d::Entity *e)
+{
+	m_entities.AddLast(e);
+	e->m_item = m_entities.GetLast();
+
+	const uint32_t entity_index = e->m_index;
+	if (entity_index >= m_entity_table.size()) {
+		m_entity_table.resize(size_t(entity_index) + 1, nullptr);
+		m_entity_generations.resize(size_t(entity_index) + 1, 1);
+	}
+	m_entity_table[entity_index] = e;
+	const size_t num_words = size_t(entity_index) / 64 + 1;
+	if (num_words > m_entity_bits.size()) {
+		m_entity_bits.resize(num_words, 0);
+		for (uint32_t i = 0; i < 64; ++i) {
+			m_filter_bits[i].resize(num_words, 0);
+		}
+	}
+	m_entity_bits[entity_index / 64] |= uint64_t(1) << (entity_index % 64);
+	m_entity_uuids[e->GetUUID()] = e;
+	AddEntityTag(e);
+	UpdateEntityFilter(e, 0);
+}
+
+void retro3d::Engine::UnregisterEntity(retro3d::Entity *e)
+{
+	const uint64_t filter_flags = e->m_filter_flags;
+	e->m_filter_flags = 0;
+	UpdateEntityFilter(e, filter_flags);
+	e->m_filter_flags = filter_flags;
+	RemoveEntityTag(e);
+	m_entity_uuids.erase(e->GetUUID());
+	m_entity_bits[e->m_index / 64] &= ~(uint64_t(1) << (e->m_index % 64));
+	m_entity_table[e->m_index] = nullptr;
+	if (++m_entity_generations[e->m_index] == 0) {
+		m_entity_generations[e->m_index] = 1; // NOTE: Generation 0 is reserved for null handles.
+	}
+	e->m_item->Remove();
+	e->m_item = nullptr;
+}
+
+void retro3d::Engine::AddEntityTag(retro3d::Entity *e)
+{
+	std::vector<retro3d::Entity*> &entities = m_entity_tags[e->m_tag];
+	e->m_tag_slot = uint32_t(entities.size());
+	entities.push_back(e);
+}
+
+void retro3d::Engine::RemoveEntityTag(retro3d::Entity *e)
+{
+	EntityTags::iterator i = m_entity_tags.find(e->m_tag);
+	if (i != m_entity_tags.end()) {
+		std::vector<retro3d::Entity*> &entities = i->second;
+		entities[e->m_tag_slot] = entities.back();
+		entities[e->m_tag_slot]->m_tag_slot = e->m_tag_slot;
+		entities.pop_back();
+		if (entities.empty() == true) {
+			m_entity_tags.erase(i);
+		}
+	}
+}
+
+void retro3d::Engine::UpdateEntityFilter(retro3d::Entity *e, uint64_t old_filter_flags)
+{
+	const uint32_t entity_index = e->m_index;
+	const uint64_t entity_bit = uint64_t(1) << (entity_index % 64);
+	for (uint64_t changed = old_filter_flags ^ e->m_filter_flags; changed != 0; changed &= changed - 1) {
+		const uint32_t flag_index = LowestBitIndex(changed);
+		if ((e->m_filter_flags & (uint64_t(1) << flag_index)) != 0) {
+			m_filter_bits[flag_index][entity_index / 64] |= entity_bit;
+		} else {
+			m_filter_bits[flag_index][entity_index / 64] &= ~entity_bit;
+		}
+	}
+}
+
+void retro3d::Engine::EnqueueDestroy(retro3d::Entity *e)
+{
+	{
+		// NOTE: The flag is tested under the lock so that an entity destroyed by two threads at once is only queued once.
+		std::lock_guard<std::mutex> lock(m_destroyed_mutex);
+		if (e->m_should_destroy == true) { return; }
+		e->m_should_destroy = true;
+		m_destroyed_entities.push_back(e);
+	}
+	MarkActivityChanged(e);
+}
+
+void retro3d::Engine::EnqueueDestroy(retro3d::Component *c)
+{
+	IComponentPool *pool = FindComponentPool(c->GetInstanceType());
+	if (pool != nullptr) {
+		pool->AddDestroyed(c);
+		pool->MarkChanged(c->GetObject()->m_index);
+	} else {
+		c->m_should_destroy = true;
+	}
+}
+
+void retro3d::Engine::MarkActivityChanged(retro3d::Entity *e)
+{
+	// NOTE: Components are only active while their entity is active.
+	for (size_t i = 0; i < m_component_pools.size(); ++i) {
+		if (m_component_pools[i]->Get(e->m_index) != nullptr) {
+			m_component_pools[i]->MarkChanged(e->m_index);
+		}
+	}
+}
+
+void retro3d::Engine::MarkActivityChanged(retro3d::Component *c)
+{
+	IComponentPool *pool = FindComponentPool(c->GetInstanceType());
+	if (pool != nullptr) {
+		pool->MarkChanged(c->GetObject()->m_index);
+	}
+}
+
+void retro3d::Engine::RepartitionComponents( void )
+{
+	for (size_t i = 0; i < m_component_pools.size(); ++i) {
+		m_component_pools[i]->Repartition();
+	}
+}
+
+uint32_t retro3d::Engine::AcquireEntityIndex( void )
+{
+	if (m_free_entity_indices.empty() == false) {
+		const uint32_t index = m_free_entity_indices.back();
+		m_free_entity_indices.pop_back();
+		return index;
+	}
+	return m_entity_index_count++;
+}
+
+retro3d::IComponentPool *retro3d::Engine::FindComponentPool(uint64_t component_class_type) const
+{
+	ComponentPools::const_iterator i = m_components.find(component_class_type);
+	return i != m_components.end() ? i->second : nullptr;
 }
 
 retro3d::Engine::Engine( void ) :
@@ -838,14 +1245,57 @@ retro3d::Engine::Engine( void ) :
 	m_input(new platform::NullInputDevice),
 	m_video(new platform::NullVideoDevice),
 	m_camera(&m_default_camera),
+	m_entity_index_count(0),
+	m_tweens(new retro3d::TweenSystem(*this)),
+	m_events(),
+	m_system_order(0), m_system_schedule_dirty(true),
 	m_frame(0),
 	m_rand(),
-	m_delta_time(1.0/60.0), m_min_delta_time(1000/120), m_max_delta_time(1000/20),
-	m_is_running(false), m_quit(true)
+	m_delta_time(1.0/60.0), m_min_delta_time(1000/120), m_max_delta_time(1000/20), m_pacer(120),
+	m_fixed_update_hz(0), m_max_fixed_steps(5), m_fixed_accumulator(0.0), m_interpolation_alpha(1.0),
+	m_is_running(false), m_quit(true), m_show_profiler(false), m_headless(false), m_late_input_sampling(false)
 {
+	const uint32_t hardware_threads = std::thread::hardware_concurrency();
+	m_workers.SetThreadCount(hardware_threads > 1 ? hardware_threads - 1 : 0);
 	AddRequiredSystems();
 	CreateBaseModels();
 	SetupTimers();
+	m_events.Subscribe<retro3d::CollisionEvent>([this](const retro3d::CollisionEvent *events, uint32_t count) { DeliverCollisions(events, count); });
+}
+
+retro3d::TimerWheel *retro3d::Engine::GetTimerWheel(retro3d::TimerType type)
+{
+	return &m_timer_wheels[type];
+}
+
+const retro3d::TimerWheel *retro3d::Engine::GetTimerWheel(retro3d::TimerType type) const
+{
+	return &m_timer_wheels[type];
+}
+
+retro3d::TweenSystem *retro3d::Engine::GetTweens( void )
+{
+	return m_tweens;
+}
+
+const retro3d::TweenSystem *retro3d::Engine::GetTweens( void ) const
+{
+	return m_tweens;
+}
+
+retro3d::EventBus *retro3d::Engine::GetEvents( void )
+{
+	return &m_events;
+}
+
+const retro3d::EventBus *retro3d::Engine::GetEvents( void ) const
+{
+	return &m_events;
+}
+
+void retro3d::Engine::SetWorkerThreadCount(uint32_t thread_count)
+{
+	m_workers.SetThreadCount(thread_count);
 }
 
 retro3d::Engine::~Engine( void )
@@ -859,6 +1309,8 @@ retro3d::Engine::~Engine( void )
 	m_input = nullptr;
 	delete m_sound;
 	m_sound = nullptr;
+	delete m_tweens;
+	m_tweens = nullptr;
 }
 
 void retro3d::Engine::SetCamera(const retro3d::Camera *camera)
@@ -922,7 +1374,44 @@ const retro3d::VideoDevice *retro3d::Engine::GetVideo( void ) const
 
 void retro3d::Engine::SetMaxUpdateFrequency(uint32_t max_hz)
 {
-	m_min_delta_time = retro3d::Time(1000 / max_hz);
+	m_min_delta_time = max_hz > 0 ? retro3d::Time(1000 / max_hz) : retro3d::Time(0);
+	m_pacer.SetFrequency(max_hz);
+}
+
+void retro3d::Engine::SetFrameSpinBudget(uint32_t microseconds)
+{
+	m_pacer.SetSpinBudget(microseconds);
+}
+
+retro3d::FramePacer::Stats retro3d::Engine::GetFramePacingStats( void ) const
+{
+	return m_pacer.GetStats();
+}
+
+void retro3d::Engine::SetHeadless( void )
+{
+	CreateVideoDevice<platform::NullVideoDevice>();
+	CreateRenderDevice<platform::NullRenderDevice>();
+	CreateSoundDevice<platform::NullSoundDevice>();
+	CreateInputDevice<platform::NullInputDevice>();
+	m_headless = true;
+	m_show_profiler = false;
+	SetMaxUpdateFrequency(0);
+}
+
+bool retro3d::Engine::IsHeadless( void ) const
+{
+	return m_headless;
+}
+
+void retro3d::Engine::SetLateInputSampling(bool late_input_sampling)
+{
+	m_late_input_sampling = late_input_sampling;
+}
+
+bool retro3d::Engine::IsLateInputSampling( void ) const
+{
+	return m_late_input_sampling;
 }
 
 void retro3d::Engine::SetMaxSimulationTimeDelta(retro3d::Time time_delta)
@@ -930,6 +1419,39 @@ void retro3d::Engine::SetMaxSimulationTimeDelta(retro3d::Time time_delta)
 	m_max_delta_time = time_delta;
 }
 
+void retro3d::Engine::ToggleProfilerOverlay( void )
+{
+	m_show_profiler = !m_show_profiler;
+}
+
+bool retro3d::Engine::IsProfilerOverlayVisible( void ) const
+{
+	return m_show_profiler;
+}
+
+bool retro3d::Engine::WriteProfilerTrace(const std::string &file, uint32_t num_frames) const
+{
+	return retro3d::Profiler::Instance().WriteChromeTrace(file, num_frames);
+}
+
+void retro3d::Engine::SetFixedUpdateFrequency(uint32_t sim_hz, uint32_t max_steps)
+{
+	m_fixed_update_hz = sim_hz;
+	m_max_fixed_steps = mmlMax(max_steps, uint32_t(1));
+	m_fixed_accumulator = 0.0;
+	m_interpolation_alpha = 1.0;
+}
+
+uint32_t retro3d::Engine::GetFixedUpdateFrequency( void ) const
+{
+	return m_fixed_update_hz;
+}
+
+double retro3d::Engine::GetInterpolationAlpha( void ) const
+{
+	return m_interpolation_alpha;
+}
+
 retro3d::Time retro3d::Engine::RealTime( void ) const
 {
 	return m_real_timer.GetScaledTime();
@@ -1065,6 +1587,207 @@ float retro3d::Engine::GetRandomFloat(float min, float max)
 	return m_rand.GetFloat(min, max);
 }
 
+namespace
+{
+
+enum
+{
+	SNAPSHOT_MAGIC   = 0x53443352, // "R3DS"
+	SNAPSHOT_VERSION = 1
+};
+
+}
+
+void retro3d::Engine::WriteSnapshot(retro3d::Snapshot &out) const
+{
+	RETRO3D_PROFILE_SCOPE("WriteSnapshot");
+
+	out.Clear();
+	retro3d::SnapshotWriter w(out);
+	w.Write(uint32_t(SNAPSHOT_MAGIC));
+	w.Write(uint32_t(SNAPSHOT_VERSION));
+	w.Write(m_frame);
+	w.Write(m_rand);
+	w.Write(m_fixed_accumulator);
+
+	w.Write(uint32_t(m_entities.GetSize()));
+	for (const mtlItem<retro3d::Entity*> *i = m_entities.GetFirst(); i != nullptr; i = i->GetNext()) {
+		const retro3d::Entity *e = i->GetItem();
+		w.Write(GetHandle(*e).GetValue());
+		w.Write(e->m_filter_flags);
+		w.Write(e->m_is_active);
+		w.Write(e->m_time_scale);
+		w.Write(e->GameLifeTime());
+	}
+
+	// NOTE: Components are written one pool at a time as [class type][count]{[entity handle][size][data]}. Pools whose components do not support snapshots are left out.
+	const uint32_t pool_count_position = w.GetPosition();
+	uint32_t pool_count = 0;
+	w.Write(pool_count);
+	for (size_t p = 0; p < m_component_pools.size(); ++p) {
+		const IComponentPool &pool = *m_component_pools[p];
+		const uint32_t pool_position = w.GetPosition();
+		w.Write(pool.GetClassType());
+		w.Write(uint32_t(0));
+		uint32_t count = 0;
+		for (uint32_t j = 0; j < pool.GetSize(); ++j) {
+			const retro3d::Component *c = pool[j];
+			const uint32_t component_position = w.GetPosition();
+			w.Write(GetHandle(*c->GetObject()).GetValue());
+			w.Write(uint32_t(0));
+			if (c->WriteSnapshot(w) == false) {
+				w.Truncate(component_position);
+				break;
+			}
+			w.Patch(component_position + uint32_t(sizeof(uint64_t)), uint32_t(w.GetPosition() - component_position - sizeof(uint64_t) - sizeof(uint32_t)));
+			++count;
+		}
+		if (count == 0) {
+			w.Truncate(pool_position);
+		} else {
+			w.Patch(pool_position + uint32_t(sizeof(uint64_t)), count);
+			++pool_count;
+		}
+	}
+	w.Patch(pool_count_position, pool_count);
+}
+
+bool retro3d::Engine::ValidateSnapshot(const retro3d::Snapshot &in) const
+{
+	// NOTE: Walks the layout without applying anything. Entities have a fixed size and components are skipped using their recorded sizes.
+	retro3d::SnapshotReader r(in);
+	uint32_t magic = 0, version = 0;
+	if (r.Read(magic) == false || r.Read(version) == false || magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION) {
+		std::cout << "[Engine::ReadSnapshot] Not a snapshot, or a snapshot of a different version." << std::endl;
+		return false;
+	}
+	r.Skip(uint32_t(sizeof(m_frame) + sizeof(m_rand) + sizeof(m_fixed_accumulator)));
+
+	uint32_t entity_count = 0;
+	r.Read(entity_count);
+	for (uint32_t i = 0; i < entity_count && r.IsFailed() == false; ++i) {
+		int32_t is_active = 0;
+		r.Skip(uint32_t(sizeof(uint64_t) + sizeof(uint64_t)));
+		r.Read(is_active);
+		r.Skip(uint32_t(sizeof(double) + sizeof(retro3d::Time)));
+		if (is_active > 1) {
+			std::cout << "[Engine::ReadSnapshot] Entity activity is out of range." << std::endl;
+			return false;
+		}
+	}
+
+	uint32_t pool_count = 0;
+	r.Read(pool_count);
+	for (uint32_t p = 0; p < pool_count && r.IsFailed() == false; ++p) {
+		uint64_t class_type = 0;
+		uint32_t count = 0;
+		r.Read(class_type);
+		r.Read(count);
+		for (uint32_t j = 0; j < count && r.IsFailed() == false; ++j) {
+			uint64_t handle = 0;
+			uint32_t size = 0;
+			r.Read(handle);
+			r.Read(size);
+			r.Skip(size);
+		}
+	}
+
+	if (r.IsFailed() == true || r.IsEnd() == false) {
+		std::cout << "[Engine::ReadSnapshot] Snapshot is truncated or has trailing data." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool retro3d::Engine::ApplySnapshot(const retro3d::Snapshot &in)
+{
+	// NOTE: Assumes a snapshot that passed ValidateSnapshot. Returns false if a component rejects its data.
+	retro3d::SnapshotReader r(in);
+	r.Skip(uint32_t(sizeof(uint32_t) + sizeof(uint32_t)));
+	r.Read(m_frame);
+	r.Read(m_rand);
+	r.Read(m_fixed_accumulator);
+
+	uint32_t entity_count = 0;
+	r.Read(entity_count);
+	for (uint32_t i = 0; i < entity_count; ++i) {
+		uint64_t handle = 0, filter_flags = 0;
+		int32_t is_active = 0;
+		double time_scale = 1.0;
+		retro3d::Time lifetime;
+		r.Read(handle);
+		r.Read(filter_flags);
+		r.Read(is_active);
+		r.Read(time_scale);
+		r.Read(lifetime);
+
+		retro3d::Entity *e = Resolve(retro3d::EntityHandle(uint32_t(handle & 0xffffffff), uint32_t(handle >> 32)));
+		if (e == nullptr) { continue; }
+
+		e->SetFilterFlags(filter_flags);
+		// NOTE: At most one call is made to switch activity, since the stored count may be any number of deactivations deep.
+		if ((is_active > 0) != (e->m_is_active > 0)) {
+			if (is_active > 0) {
+				e->m_is_active = 0;
+				e->Activate();
+			} else {
+				e->Deactivate();
+			}
+		}
+		e->m_is_active = is_active;
+		e->SetTimeScale(time_scale);
+		e->m_game_time_base = lifetime;
+		e->m_game_time_anchor = m_game_time;
+		e->RescheduleTimers();
+	}
+
+	uint32_t pool_count = 0;
+	r.Read(pool_count);
+	for (uint32_t p = 0; p < pool_count; ++p) {
+		uint64_t class_type = 0;
+		uint32_t count = 0;
+		r.Read(class_type);
+		r.Read(count);
+		const IComponentPool *pool = FindComponentPool(class_type);
+		for (uint32_t j = 0; j < count; ++j) {
+			uint64_t handle = 0;
+			uint32_t size = 0;
+			r.Read(handle);
+			r.Read(size);
+			const uint32_t end = r.GetPosition() + size;
+			const retro3d::Entity *e = Resolve(retro3d::EntityHandle(uint32_t(handle & 0xffffffff), uint32_t(handle >> 32)));
+			retro3d::Component *c = (pool != nullptr && e != nullptr) ? pool->Get(e->m_index) : nullptr;
+			if (c != nullptr && (c->ReadSnapshot(r) == false || r.IsFailed() == true || r.GetPosition() > end)) {
+				return false;
+			}
+			r.Skip(end - r.GetPosition());
+		}
+	}
+	return r.IsFailed() == false;
+}
+
+bool retro3d::Engine::ReadSnapshot(const retro3d::Snapshot &in)
+{
+	RETRO3D_PROFILE_SCOPE("ReadSnapshot");
+
+	if (ValidateSnapshot(in) == false) {
+		return false;
+	}
+
+	// NOTE: Component data can only be checked by the components as they read it, so the current state is kept and restored if a component rejects its data.
+	WriteSnapshot(m_snapshot_backup);
+	if (ApplySnapshot(in) == false) {
+		std::cout << "[Engine::ReadSnapshot] Component data is malformed, snapshot not applied." << std::endl;
+		if (ApplySnapshot(m_snapshot_backup) == false) {
+			// NOTE: The backup was written by the same components, so this means a component can not read its own snapshot.
+			std::cout << "[Engine::ReadSnapshot] Failed to restore the state before the snapshot, engine state is inconsistent." << std::endl;
+			RETRO3D_ASSERT(false);
+		}
+		return false;
+	}
+	return true;
+}
+
 void retro3d::Engine::Run( void )
 {
 	if (m_is_running == true) { return; }
@@ -1090,105 +1813,60 @@ retro3d::Entity *retro3d::Engine::SpawnEntity(const std::string &name)
 	// FIXME: Not gonna work if the schematic requires the entity to have an engine connected.
 	retro3d::Entity *e = retro3d::Singleton< retro3d::Factory< retro3d::Entity > >::Instance().Assemble(name);
 	e->m_engine = this;
+	e->m_index = AcquireEntityIndex();
+	e->m_real_time_spawn = m_real_time;
+	e->m_sim_time_spawn = m_sim_time;
 	e->m_game_timer.SetParent(&m_game_timer);
-	e->m_delta_time = m_delta_time;
-	m_entities.AddLast(e);
+	e->m_game_time_anchor = m_game_time;
+	RegisterEntity(e);
 	e->OnSpawn();
 	return e;
 }
 
 bool retro3d::Engine::FindEntityByTag(const std::string &tag, mtlList<retro3d::Entity*> &results, bool search_inactive)
 {
-	mtlItem<retro3d::Entity*> *i = m_entities.GetFirst();
-	if (search_inactive == false) {
-		while (i != nullptr) {
-			if (tag == i->GetItem()->GetTag() && i->GetItem()->IsActive()) {
-				results.AddLast(i->GetItem());
-			}
-			i = i->GetNext();
-		}
-	} else {
-		while (i != nullptr) {
-			if (tag == i->GetItem()->GetTag()) {
-				results.AddLast(i->GetItem());
-			}
-			i = i->GetNext();
-		}
-	}
+	ForEachEntityByTag(tag, [&results](retro3d::Entity &e) { results.AddLast(&e); }, search_inactive);
 	return results.GetSize() > 0;
 }
 
 bool retro3d::Engine::FindEntityByFilter(uint64_t filter_flags, mtlList<retro3d::Entity*> &results, retro3d::Engine::FilterSearchMode filter_search, bool search_inactive)
 {
-	mtlItem<retro3d::Entity*> *i = m_entities.GetFirst();
-	if (search_inactive == false) {
-		while (i != nullptr) {
-			if (i->GetItem()->IsActive() == true) {
-				switch (filter_search) {
-				case FILTERSEARCH_ANY:
-					if ((i->GetItem()->GetFilterFlags() & filter_flags) != 0) {
-						results.AddLast(i->GetItem());
-					}
-					break;
-				case FILTERSEARCH_EXACT:
-					if (i->GetItem()->GetFilterFlags() == filter_flags) {
-						results.AddLast(i->GetItem());
-					}
-					break;
-				case FILTERSEARCH_INCLUSIVE:
-					if ((i->GetItem()->GetFilterFlags() & filter_flags) == filter_flags) {
-						results.AddLast(i->GetItem());
-					}
-					break;
-				}
-			}
-			i = i->GetNext();
-		}
-	} else {
-		while (i != nullptr) {
-			if (i->GetItem()->IsActive() == true) {
-				switch (filter_search) {
-				case FILTERSEARCH_ANY:
-					if ((i->GetItem()->GetFilterFlags() & filter_flags) != 0) {
-						results.AddLast(i->GetItem());
-					}
-					break;
-				case FILTERSEARCH_EXACT:
-					if (i->GetItem()->GetFilterFlags() == filter_flags) {
-						results.AddLast(i->GetItem());
-					}
-					break;
-				case FILTERSEARCH_INCLUSIVE:
-					if ((i->GetItem()->GetFilterFlags() & filter_flags) == filter_flags) {
-						results.AddLast(i->GetItem());
-					}
-					break;
-				}
-			}
-			i = i->GetNext();
-		}
-	}
+	ForEachEntityByFilter(filter_flags, [&results](retro3d::Entity &e) { results.AddLast(&e); }, filter_search, search_inactive);
 	return results.GetSize() > 0;
 }
 
+retro3d::EntityHandle retro3d::Engine::GetHandle(const retro3d::Entity &e) const
+{
+	return retro3d::EntityHandle(e.m_index, m_entity_generations[e.m_index]);
+}
+
+retro3d::Entity *retro3d::Engine::Resolve(retro3d::EntityHandle h)
+{
+	const uint32_t i = h.GetIndex();
+	return (i < m_entity_table.size() && m_entity_generations[i] == h.GetGeneration()) ? m_entity_table[i] : nullptr;
+}
+
+const retro3d::Entity *retro3d::Engine::Resolve(retro3d::EntityHandle h) const
+{
+	const uint32_t i = h.GetIndex();
+	return (i < m_entity_table.size() && m_entity_generations[i] == h.GetGeneration()) ? m_entity_table[i] : nullptr;
+}
+
 retro3d::Entity *retro3d::Engine::FindEntityByUUID(uint64_t uuid, bool search_inactive)
 {
-	mtlItem<retro3d::Entity*> *i = m_entities.GetFirst();
-	while (i != nullptr) {
-		if (i->GetItem()->GetUUID() == uuid) {
-			if (search_inactive == false && i->GetItem()->IsActive() == false) {
-				return nullptr; // We found the entity, but it is not active and we do not include inactive results.
-			}
-			return i->GetItem();
-		}
-		i = i->GetNext();
+	std::unordered_map<uint64_t, retro3d::Entity*>::const_iterator i = m_entity_uuids.find(uuid);
+	if (i == m_entity_uuids.end()) {
+		return nullptr;
 	}
-
-	return nullptr;
+	if (search_inactive == false && i->second->IsActive() == false) {
+		return nullptr; // We found the entity, but it is not active and we do not include inactive results.
+	}
+	return i->second;
 }
 
 mtlShared<retro3d::Model> retro3d::Engine::DefaultModel( void )
 {
+	std::lock_guard<std::recursive_mutex> lock(g_base_content_mutex);
 	mtlShared<retro3d::Model> s;
 	if (retro3d::Model::Library.Exists("Default", s) == false) {
 		s.New();
@@ -1198,11 +1876,20 @@ mtlShared<retro3d::Model> retro3d::Engine::DefaultModel( void )
 		retro3d::Model::Library.Store(s, "Default");
 		retro3d::Model::Library.SetFallback(s);
 	}
-	return s;
+	// NOTE: The library entry is shared by all engines. Callers get a deep copy made under the lock, so the reference counts of the entry and its textures are never touched outside of it.
+	mtlShared<retro3d::Model> copy;
+	copy.New();
+	*copy.GetShared() = *s.GetShared();
+	for (int i = 0; i < copy->m.GetSize(); ++i) {
+		copy->m[i].td = CopyTexture(s->m[i].td);
+	}
+	copy->lightmap = CopyTexture(s->lightmap);
+	return copy;
 }
 
 mtlShared<retro3d::Texture> retro3d::Engine::DefaultTexture( void )
 {
+	std::lock_guard<std::recursive_mutex> lock(g_base_content_mutex);
 	mtlShared<retro3d::Texture> s;
 	if (retro3d::Texture::Library.Exists("Default", s) == false) {
 		tiny3d::Image img;
@@ -1212,5 +1899,5 @@ mtlShared<retro3d::Texture> retro3d::Engine::DefaultTexture( void )
 		retro3d::Texture::Library.Store(s, "Default");
 		retro3d::Texture::Library.SetFallback(s);
 	}
-	return s;
+	return CopyTexture(s);
 }
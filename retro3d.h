@@ -1,16 +1,26 @@
 #ifndef RETRO3D_H
 #define RETRO3D_H
 
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 #include "common/MiniLib/MTL/mtlList.h"
 #include "common/MiniLib/MTL/mtlPointer.h"
 #include "common/MiniLib/MML/mmlRandom.h"
+#include "common/retro_frame_pacer.h"
 #include "common/retro_time.h"
+#include "common/retro_timer_wheel.h"
+#include "common/retro_workers.h"
+#include "common/retro_profiler.h"
 #include "frontend/retro_render_device.h"
 #include "ecs/retro_component.h"
+#include "ecs/retro_component_pool.h"
+#include "ecs/retro_event_bus.h"
+#include "ecs/retro_handle.h"
 #include "ecs/retro_system.h"
 #include "graphics/retro_camera.h"
 #include "serial/retro_import.h"
+#include "serial/retro_snapshot.h"
 #include "frontend/retro_sound_device.h"
 #include "frontend/retro_input_device.h"
 #include "frontend/retro_video_device.h"
@@ -18,14 +28,18 @@
 namespace retro3d
 {
 
+class TweenSystem;
+struct CollisionEvent;
+
 class Engine
 {
+	friend class Entity;
+	friend class Component;
+
 private:
 	typedef std::unordered_map<uint64_t, ISystem*>                 Systems;
-	typedef std::unordered_map<uint64_t, retro3d::Component*>      ComponentClass; // ALL components in this map are GUARANTEED being the SAME type - uint64_t = Component class ID
-	typedef std::unordered_map<uint64_t, ComponentClass>           Components; // all components - uint64_t = Entity instance ID
-	typedef std::unordered_map<uint64_t, ComponentClass::iterator> ComponentClassIters;
-	typedef std::unordered_map<uint64_t, ComponentClassIters>      ComponentIters;
+	typedef std::unordered_map<uint64_t, IComponentPool*>          ComponentPools; // uint64_t = Component class ID
+	typedef std::unordered_map<std::string, std::vector<Entity*> > EntityTags; // Entities by tag, unordered. Entity::m_tag_slot is the position in the vector.
 	// [component_class_id][entity_instance_id] = access component of individual entity (if existing)
 	// [component_class_id] = access all components of certain type
 
@@ -36,11 +50,34 @@ private:
 	retro3d::VideoDevice        *m_video;
 	const retro3d::Camera       *m_camera;
 	retro3d::Camera              m_default_camera;
-	Components                   m_components_pending_init;
-	Components                   m_components;
+	ComponentPools               m_components;
+	std::vector<IComponentPool*> m_component_pools; // Same pools as m_components, in creation order. Safe to iterate while new pools are added.
+	std::vector<IComponentPool*> m_pending_pools; // Pools that have had components added since the last InitComponents, in order of first addition.
+	std::vector<IComponentPool*> m_spawned_pools;
+	std::vector<retro3d::Component*> m_spawned_components;
+	std::vector<size_t>          m_spawned_first; // m_spawned_components[m_spawned_first[i]] to m_spawned_components[m_spawned_first[i + 1]] were committed by m_spawned_pools[i].
 	mtlList< retro3d::Entity* >  m_entities;
+	std::vector<retro3d::Entity*> m_entity_table; // Entity index -> entity.
+	std::vector<uint32_t>        m_entity_generations; // Entity index -> generation, bumped when the entity is deleted.
+	std::unordered_map<uint64_t, retro3d::Entity*> m_entity_uuids;
+	EntityTags                   m_entity_tags;
+	std::vector<uint64_t>        m_entity_bits; // Bit set of live entity indices.
+	std::vector<uint64_t>        m_filter_bits[64]; // Bit set of entity indices per filter flag.
+	std::vector<retro3d::Entity*> m_destroyed_entities; // Entities marked for destruction since the last call to DestroyEntities.
+	std::mutex                   m_destroyed_mutex; // Guards m_destroyed_entities, since systems may destroy entities from worker threads.
+	std::vector<retro3d::Entity*> m_dying_entities;
+	std::vector<retro3d::Component*> m_dying_components;
+	std::vector<size_t>          m_dying_first; // m_dying_components[m_dying_first[i]] to m_dying_components[m_dying_first[i + 1]] belong to m_component_pools[i].
+	std::vector<uint32_t>        m_free_entity_indices;
+	uint32_t                     m_entity_index_count;
 	Systems                      m_systems;
 	Systems                      m_systems_pending_init;
+	std::vector< std::vector<ISystem*> > m_system_schedule; // Groups of systems that can run concurrently, executed group by group.
+	retro3d::WorkerPool          m_workers;
+	retro3d::TweenSystem        *m_tweens;
+	retro3d::EventBus            m_events;
+	uint64_t                     m_system_order;
+	bool                         m_system_schedule_dirty;
 	retro3d::Time                m_frame_start_time;
 	retro3d::Time                m_frame_time;
 	retro3d::RealTimeTimer       m_real_timer; // 1 s on clock = 1 s in real life.
@@ -49,13 +86,32 @@ private:
 	retro3d::Time                m_real_time;
 	retro3d::Time                m_sim_time;
 	retro3d::Time                m_game_time;
+	retro3d::TimerWheel          m_timer_wheels[3]; // Indexed by retro3d::TimerType. Advanced to the engine times once per frame.
 	uint64_t                     m_frame;
 	mmlRandom                    m_rand;
 	double                       m_delta_time;
 	retro3d::Time                m_min_delta_time;
 	retro3d::Time                m_max_delta_time;
+	retro3d::FramePacer          m_pacer; // Holds frames to the maximum update frequency.
+	uint32_t                     m_fixed_update_hz; // 0 means variable time step.
+	uint32_t                     m_max_fixed_steps;
+	double                       m_fixed_accumulator; // Game time (in seconds) not yet consumed by fixed steps.
+	retro3d::Snapshot            m_snapshot_backup; // State restored if a component rejects its data in ReadSnapshot.
+	double                       m_interpolation_alpha;
 	bool                         m_is_running;
 	bool                         m_quit;
+	bool                         m_show_profiler;
+	bool                         m_headless;
+	bool                         m_late_input_sampling;
+
+private:
+	// Determines which systems are updated by TickSystems.
+	enum SystemPass
+	{
+		SystemPass_All,
+		SystemPass_Simulation,  // Only systems marked as simulation.
+		SystemPass_Presentation // Only systems not marked as simulation.
+	};
 
 private:
 	static void CreateBaseModels( void );
@@ -67,17 +123,40 @@ private:
 	void UpdateDevices( void );
 	void InitSystems( void );
 	void InitComponents( void );
+	void RecordLastTransforms( void );
 	void TickComponents( void );
-	void TickSystems( void );
+	void BuildSystemSchedule( void );
+	void UpdateSystem(retro3d::ISystem *system, SystemPass pass);
+	void TickSystems(SystemPass pass);
+	void TickFixedSteps( void );
 	void TickEntities( void );
 	void DestroySystems( void );
 	void DestroyComponents( void );
 	void DestroyEntities( void );
 	void DetectTermination( void );
 	void TickTime( void );
+	void DispatchEvents( void );
+	void DeliverCollisions(const retro3d::CollisionEvent *events, uint32_t count);
 	void Tick( void );
 	void Cleanup( void );
-
+	void RegisterEntity(retro3d::Entity *e);
+	void UnregisterEntity(retro3d::Entity *e);
+	void AddEntityTag(retro3d::Entity *e);
+	void RemoveEntityTag(retro3d::Entity *e);
+	void UpdateEntityFilter(retro3d::Entity *e, uint64_t old_filter_flags);
+	void EnqueueDestroy(retro3d::Entity *e);
+	void EnqueueDestroy(retro3d::Component *c);
+	void MarkActivityChanged(retro3d::Entity *e);
+	void MarkActivityChanged(retro3d::Component *c);
+	void RepartitionComponents( void );
+	uint32_t AcquireEntityIndex( void );
+	bool ValidateSnapshot(const retro3d::Snapshot &in) const;
+	bool ApplySnapshot(const retro3d::Snapshot &in);
+	IComponentPool *FindComponentPool(uint64_t component_class_type) const;
+
+	static uint32_t LowestBitIndex(uint64_t x);
+
+	template < typename component_t > ComponentPool<component_t> *GetComponentPool( void );
 	template < typename component_t > component_t       *GetFinishedComponent(retro3d::Entity &e);
 	template < typename component_t > const component_t *GetFinishedComponent(const retro3d::Entity &e) const;
 	template < typename component_t > component_t       *GetPendingComponent(retro3d::Entity &e);
@@ -130,12 +209,57 @@ public:
 	retro3d::VideoDevice       *GetVideo( void );
 	const retro3d::VideoDevice *GetVideo( void ) const;
 
-	// Set the maximum updates that the engine can do. If an update cycle finishes early it rests for the remaining time.
+	// Returns the timer wheel that schedules callbacks on the engine clock of the given type. Callbacks are called once per frame, before components are updated.
+	retro3d::TimerWheel       *GetTimerWheel(retro3d::TimerType type);
+	const retro3d::TimerWheel *GetTimerWheel(retro3d::TimerType type) const;
+
+	// Returns the tweens of the engine. Include ecs/systems/retro_tween_system.h to use.
+	retro3d::TweenSystem       *GetTweens( void );
+	const retro3d::TweenSystem *GetTweens( void ) const;
+
+	// Returns the event bus of the engine. Queued events are dispatched after each simulation step and once more after the remaining systems have updated.
+	retro3d::EventBus       *GetEvents( void );
+	const retro3d::EventBus *GetEvents( void ) const;
+
+	// Sets the number of worker threads used to run systems concurrently. 0 runs all systems on the calling thread.
+	void SetWorkerThreadCount(uint32_t thread_count);
+
+	// Set the maximum updates that the engine can do. If an update cycle finishes early it rests for the remaining time. 0 Hz never rests.
 	void SetMaxUpdateFrequency(uint32_t max_hz);
 
+	// Sets how long before the end of a frame the engine stops sleeping and spins instead, trading CPU time for more precise frame timing.
+	void SetFrameSpinBudget(uint32_t microseconds);
+
+	// Returns statistics of how precisely frames end at the maximum update frequency.
+	retro3d::FramePacer::Stats GetFramePacingStats( void ) const;
+
+	// Replaces all devices with null devices, skips rendering and presentation, and lifts the update frequency limit so that the simulation runs as fast as possible.
+	// NOTE: Call SetMaxUpdateFrequency afterwards to run at a fixed rate instead, and SetTimeScale to accelerate game time relative to real time.
+	// NOTE: Several headless engines may tick on different threads, but asset libraries, the component factory and the profiler are process-wide. Engine construction is locked and DefaultModel/DefaultTexture hand out unshared copies; loading, storing or fetching other assets while engines tick on other threads is not safe, unless RETRO3D_THREAD_LOCAL_ASSETS is defined.
+	void SetHeadless( void );
+	bool IsHeadless( void ) const;
+
+	// Determines if the engine samples the latest input right before entities update, in addition to the start of the frame. Entities typically act on input after components and systems have run, so this shortens the time between reading and acting on input. Off by default, since sampling again changes input deltas and timing within a frame.
+	void SetLateInputSampling(bool late_input_sampling);
+	bool IsLateInputSampling( void ) const;
+
 	// Set the maximum simulation time deltas. Does not prevent that DeltaTime returns a larger delta is the user has scaled the time further.
 	void SetMaxSimulationTimeDelta(retro3d::Time time_delta);
 
+	// Runs components, entities and simulation systems at a fixed rate, as many times per frame as needed to keep up, but at most max_steps times. Other systems run once per frame. 0 Hz restores a variable time step.
+	void SetFixedUpdateFrequency(uint32_t sim_hz, uint32_t max_steps = 5);
+	uint32_t GetFixedUpdateFrequency( void ) const;
+
+	// Returns how far (0-1) game time has progressed from the last fixed step towards the next. Used to interpolate rendered transforms. Always 1 with a variable time step.
+	double GetInterpolationAlpha( void ) const;
+
+	// Toggles the on-screen summary of the frame profiler.
+	void ToggleProfilerOverlay( void );
+	bool IsProfilerOverlayVisible( void ) const;
+
+	// Writes the profiler markers of the last num_frames frames to a Chrome trace_event JSON file.
+	bool WriteProfilerTrace(const std::string &file, uint32_t num_frames = 60) const;
+
 	// [DEPRECATED] Returns the scaled game time elapsed since Run was called.
 //	double   Time( void ) const; // [DEPRECATED] Replaced by RealTime
 
@@ -204,6 +328,13 @@ public:
 	// Returns a random 32 bit floating point number in the range from min up to, but not including, max.
 	float GetRandomFloat(float min, float max);
 
+	// Writes the frame counter, random number generator, the state of all entities and the state of components whose types support snapshots to a flat buffer.
+	void WriteSnapshot(retro3d::Snapshot &out) const;
+
+	// Restores a snapshot written by WriteSnapshot. Entities are matched by handle, so entities and components that no longer exist are skipped and entities spawned since are left untouched. Returns false, and leaves the engine as it was, if the snapshot is malformed.
+	// NOTE: The engine clocks are not rewound. Entity lifetimes and timers are restored relative to the current engine time.
+	bool ReadSnapshot(const retro3d::Snapshot &in);
+
 	// Starts the main engine loop, and quits only if a entity, system, or component calls the engine Quit function or if there are no valid objects for the engine to work on.
 	void Run( void );
 
@@ -216,6 +347,10 @@ public:
 	// Spawn an entity by C++ class name or prefab name. The user must register names and schematics manually.
 	retro3d::Entity *SpawnEntity(const std::string &name);
 
+	// Calls fn(retro3d::Entity&) for every entity with the given tag. Cost is proportional to the number of entities with the tag.
+	// NOTE: Tags may not be changed from within 'fn'.
+	template < typename fn_t > void ForEachEntityByTag(const std::string &tag, fn_t fn, bool search_inactive = false);
+
 	// Find entities by tag.
 	bool FindEntityByTag(const std::string &tag, mtlList<retro3d::Entity*> &results, bool search_inactive = false);
 
@@ -230,9 +365,26 @@ public:
 	// Find entities by filter given a filter search mode.
 	bool FindEntityByFilter(uint64_t filter_flags, mtlList<retro3d::Entity*> &results, FilterSearchMode filter_search = FILTERSEARCH_ANY, bool search_inactive = false);
 
+	// Calls fn(retro3d::Entity&) for every entity matching the filter given a filter search mode.
+	template < typename fn_t > void ForEachEntityByFilter(uint64_t filter_flags, fn_t fn, FilterSearchMode filter_search = FILTERSEARCH_ANY, bool search_inactive = false);
+
 	// Find entity by UUID
 	retro3d::Entity *FindEntityByUUID(uint64_t uuid, bool search_inactive = false);
 
+	// Returns a handle to the entity that can be stored across frames.
+	retro3d::EntityHandle GetHandle(const retro3d::Entity &e) const;
+
+	// Returns a handle to the component that can be stored across frames.
+	template < typename component_t > retro3d::ComponentHandle<component_t> GetComponentHandle(const component_t &c) const;
+
+	// Returns the entity referred to by the handle. Null if the entity has been deleted.
+	retro3d::Entity       *Resolve(retro3d::EntityHandle h);
+	const retro3d::Entity *Resolve(retro3d::EntityHandle h) const;
+
+	// Returns the component referred to by the handle. Null if the component has been removed, even if the entity has since been given a new component of the type.
+	template < typename component_t > component_t       *Resolve(retro3d::ComponentHandle<component_t> h);
+	template < typename component_t > const component_t *Resolve(retro3d::ComponentHandle<component_t> h) const;
+
 	// Adds a component to an entity and returns a reference to it, including its actual type.
 	template < typename component_t, typename... Args > component_t *AddComponent(retro3d::Entity &e, Args&&... args);
 
@@ -254,10 +406,12 @@ public:
 	template < typename system_t > const system_t *GetSystem( void ) const;
 
 public:
-	// Return a reference to a default model mainly used to display errors.
+	// Returns a copy of the default model mainly used to display errors.
+	// NOTE: The copy, including its textures, is not shared with the asset library, so engines on different threads can use it freely.
 	static mtlShared<retro3d::Model> DefaultModel( void );
 
-	// Returns a reference to a texture mainly used to display errors.
+	// Returns a copy of the default texture mainly used to display errors.
+	// NOTE: The copy is not shared with the asset library, so engines on different threads can use it freely.
 	static mtlShared<retro3d::Texture> DefaultTexture( void );
 };
 
@@ -300,13 +454,40 @@ void retro3d::Engine::CreateVideoDevice( void )
 
 #include "ecs/retro_entity.h"
 
+inline uint32_t retro3d::Engine::LowestBitIndex(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return uint32_t(__builtin_ctzll(x));
+#else
+	uint32_t i = 0;
+	while ((x & 1) == 0) {
+		x >>= 1;
+		++i;
+	}
+	return i;
+#endif
+}
+
 template < typename component_t >
-component_t *retro3d::Engine::GetFinishedComponent(retro3d::Entity &e)
+retro3d::ComponentPool<component_t> *retro3d::Engine::GetComponentPool( void )
 {
-	Components::iterator i = m_components.find(component_t::GetClassType());
+	ComponentPools::iterator i = m_components.find(component_t::GetClassType());
 	if (i != m_components.end()) {
-		ComponentClass::iterator j = i->second.find(e.GetUUID());
-		return j != i->second.end() ? mtlCast<component_t>(j->second) : nullptr;
+		return static_cast<ComponentPool<component_t>*>(i->second);
+	}
+	ComponentPool<component_t> *pool = new ComponentPool<component_t>;
+	m_components[component_t::GetClassType()] = pool;
+	m_component_pools.push_back(pool);
+	return pool;
+}
+
+template < typename component_t >
+component_t *retro3d::Engine::GetFinishedComponent(retro3d::Entity &e)
+{
+	const IComponentPool *pool = FindComponentPool(component_t::GetClassType());
+	if (pool != nullptr) {
+		retro3d::Component *c = pool->Get(e.m_index);
+		return c != nullptr ? mtlCast<component_t>(c) : nullptr;
 	}
 	return nullptr;
 }
@@ -314,10 +495,10 @@ component_t *retro3d::Engine::GetFinishedComponent(retro3d::Entity &e)
 template < typename component_t >
 const component_t *retro3d::Engine::GetFinishedComponent(const retro3d::Entity &e) const
 {
-	Components::const_iterator i = m_components.find(component_t::GetClassType());
-	if (i != m_components.end()) {
-		ComponentClass::const_iterator j = i->second.find(e.GetUUID());
-		return j != i->second.end() ? mtlCast<component_t>(j->second) : nullptr;
+	const IComponentPool *pool = FindComponentPool(component_t::GetClassType());
+	if (pool != nullptr) {
+		retro3d::Component *c = pool->Get(e.m_index);
+		return c != nullptr ? mtlCast<component_t>(c) : nullptr;
 	}
 	return nullptr;
 }
@@ -325,10 +506,10 @@ const component_t *retro3d::Engine::GetFinishedComponent(const retro3d::Entity &
 template < typename component_t >
 component_t *retro3d::Engine::GetPendingComponent(retro3d::Entity &e)
 {
-	Components::iterator i = m_components_pending_init.find(component_t::GetClassType());
-	if (i != m_components_pending_init.end()) {
-		ComponentClass::iterator j = i->second.find(e.GetUUID());
-		return j != i->second.end() ? mtlCast<component_t>(j->second) : nullptr;
+	IComponentPool *pool = FindComponentPool(component_t::GetClassType());
+	if (pool != nullptr) {
+		retro3d::Component *c = pool->GetPending(e.m_index);
+		return c != nullptr ? mtlCast<component_t>(c) : nullptr;
 	}
 	return nullptr;
 }
@@ -336,10 +517,10 @@ component_t *retro3d::Engine::GetPendingComponent(retro3d::Entity &e)
 template < typename component_t >
 const component_t *retro3d::Engine::GetPendingComponent(const retro3d::Entity &e) const
 {
-	Components::const_iterator i = m_components_pending_init.find(component_t::GetClassType());
-	if (i != m_components_pending_init.end()) {
-		ComponentClass::const_iterator j = i->second.find(e.GetUUID());
-		return j != i->second.end() ? mtlCast<component_t>(j->second) : nullptr;
+	const IComponentPool *pool = FindComponentPool(component_t::GetClassType());
+	if (pool != nullptr) {
+		retro3d::Component *c = pool->GetPending(e.m_index);
+		return c != nullptr ? mtlCast<component_t>(c) : nullptr;
 	}
 	return nullptr;
 }
@@ -372,17 +553,93 @@ const system_t *retro3d::Engine::GetPendingSystem( void ) const
 	return i != m_systems_pending_init.end() ? mtlCast<system_t>(i->second) : nullptr;
 }
 
+template < typename fn_t >
+void retro3d::Engine::ForEachEntityByTag(const std::string &tag, fn_t fn, bool search_inactive)
+{
+	EntityTags::iterator i = m_entity_tags.find(tag);
+	if (i != m_entity_tags.end()) {
+		const std::vector<retro3d::Entity*> &entities = i->second;
+		for (size_t j = 0; j < entities.size(); ++j) {
+			if (search_inactive == true || entities[j]->IsActive() == true) {
+				fn(*entities[j]);
+			}
+		}
+	}
+}
+
+template < typename fn_t >
+void retro3d::Engine::ForEachEntityByFilter(uint64_t filter_flags, fn_t fn, retro3d::Engine::FilterSearchMode filter_search, bool search_inactive)
+{
+	// NOTE: Candidates are found by combining the bit sets of the enabled flags one word (64 entities) at a time.
+	const size_t num_words = m_entity_bits.size();
+	for (size_t w = 0; w < num_words; ++w) {
+		uint64_t word = (filter_search == FILTERSEARCH_ANY) ? 0 : m_entity_bits[w];
+		for (uint64_t flags = filter_flags; flags != 0; flags &= flags - 1) {
+			const uint32_t flag_index = LowestBitIndex(flags);
+			if (filter_search == FILTERSEARCH_ANY) {
+				word |= m_filter_bits[flag_index][w];
+			} else {
+				word &= m_filter_bits[flag_index][w];
+			}
+		}
+		for (; word != 0; word &= word - 1) {
+			retro3d::Entity *e = m_entity_table[w * 64 + LowestBitIndex(word)];
+			if (filter_search == FILTERSEARCH_EXACT && e->GetFilterFlags() != filter_flags) { continue; }
+			if (search_inactive == true || e->IsActive() == true) {
+				fn(*e);
+			}
+		}
+	}
+}
+
+template < typename component_t >
+retro3d::ComponentHandle<component_t> retro3d::Engine::GetComponentHandle(const component_t &c) const
+{
+	// NOTE: Components of an entity leave their pools before the entity index is reused, so the slot generation alone identifies the component.
+	const IComponentPool *pool = FindComponentPool(component_t::GetClassType());
+	const uint32_t entity_index = c.GetObject()->m_index;
+	return pool != nullptr ? retro3d::ComponentHandle<component_t>(entity_index, pool->GetGeneration(entity_index)) : retro3d::ComponentHandle<component_t>();
+}
+
+template < typename component_t >
+component_t *retro3d::Engine::Resolve(retro3d::ComponentHandle<component_t> h)
+{
+	const IComponentPool *pool = FindComponentPool(component_t::GetClassType());
+	if (h.IsNull() == true || pool == nullptr || pool->GetGeneration(h.GetIndex()) != h.GetGeneration()) {
+		return nullptr;
+	}
+	retro3d::Component *c = pool->Get(h.GetIndex());
+	if (c == nullptr) {
+		c = pool->GetPending(h.GetIndex());
+	}
+	return c != nullptr ? mtlCast<component_t>(c) : nullptr;
+}
+
+template < typename component_t >
+const component_t *retro3d::Engine::Resolve(retro3d::ComponentHandle<component_t> h) const
+{
+	const IComponentPool *pool = FindComponentPool(component_t::GetClassType());
+	if (h.IsNull() == true || pool == nullptr || pool->GetGeneration(h.GetIndex()) != h.GetGeneration()) {
+		return nullptr;
+	}
+	retro3d::Component *c = pool->Get(h.GetIndex());
+	if (c == nullptr) {
+		c = pool->GetPending(h.GetIndex());
+	}
+	return c != nullptr ? mtlCast<component_t>(c) : nullptr;
+}
+
 template < typename entity_t, typename... Args >
 entity_t *retro3d::Engine::SpawnEntity(Args&&... args)
 {
 	entity_t *e = new entity_t(std::forward<Args>(args)...);
 	e->m_engine = this;
+	e->m_index = AcquireEntityIndex();
 	e->m_real_time_spawn = m_real_time;
 	e->m_sim_time_spawn = m_sim_time;
 	e->m_game_timer.SetParent(&m_game_timer);
-//	e->m_delta_time = m_delta_time * e->m_time_scale;
-	e->m_delta_time = m_delta_time;
-	m_entities.AddLast(e);
+	e->m_game_time_anchor = m_game_time;
+	RegisterEntity(e);
 	dynamic_cast<retro3d::Entity*>(e)->OnSpawn(); // If entity_t != Entity, then Engine does not have access to protected OnSpawn, so use virtual function in base instead.
 	return e;
 }
@@ -392,9 +649,12 @@ component_t *retro3d::Engine::AddComponent(retro3d::Entity &e, Args&&... args)
 {
 	component_t *c = GetComponent<component_t>(e);
 	if (e.m_should_destroy == false && c == nullptr) {
-		c = new component_t(std::forward<Args>(args)...);
+		ComponentPool<component_t> *pool = GetComponentPool<component_t>();
+		c = pool->New(std::forward<Args>(args)...);
 		c->m_object = &e;
-		m_components_pending_init[component_t::GetClassType()][e.GetUUID()] = c;
+		if (pool->AddPending(e.m_index, c) == true) {
+			m_pending_pools.push_back(pool);
+		}
 	}
 	return c;
 }
@@ -429,6 +689,8 @@ system_t *retro3d::Engine::AddSystem(Args&&... args)
 	if (s == nullptr) {
 		s = new system_t(std::forward<Args>(args)...);
 		s->m_engine = this;
+		s->m_name = s->GetName();
+		s->m_order = m_system_order++;
 		m_systems_pending_init[system_t::GetClassType()] = s;
 	}
 	return s;
@@ -0,0 +1,141 @@
+#include "retro_snapshot.h"
+
+namespace
+{
+
+enum { DELTA_MERGE_GAP = 8 }; // Unchanged stretches shorter than this are included in a run rather than starting a new one.
+
+}
+
+void retro3d::Snapshot::Clear( void )
+{
+	m_data.clear();
+}
+
+const std::vector<uint8_t> &retro3d::Snapshot::GetData( void ) const
+{
+	return m_data;
+}
+
+std::vector<uint8_t> &retro3d::Snapshot::GetData( void )
+{
+	return m_data;
+}
+
+uint32_t retro3d::Snapshot::GetSize( void ) const
+{
+	return uint32_t(m_data.size());
+}
+
+void retro3d::Snapshot::WriteDelta(const retro3d::Snapshot &base, retro3d::Snapshot &delta) const
+{
+	// NOTE: The delta is the size of this snapshot followed by runs of [offset][length][bytes]. Bytes past the end of the base always differ.
+	delta.Clear();
+	retro3d::SnapshotWriter out(delta);
+	const uint32_t size = GetSize();
+	const uint32_t base_size = base.GetSize();
+	out.Write(size);
+
+	uint32_t i = 0;
+	while (i < size) {
+		while (i < size && i < base_size && m_data[i] == base.m_data[i]) {
+			++i;
+		}
+		if (i >= size) { break; }
+
+		const uint32_t start = i;
+		uint32_t end = i;
+		uint32_t gap = 0;
+		while (i < size && gap < DELTA_MERGE_GAP) {
+			if (i < base_size && m_data[i] == base.m_data[i]) {
+				++gap;
+			} else {
+				gap = 0;
+				end = i + 1;
+			}
+			++i;
+		}
+		i = end;
+		out.Write(start);
+		out.Write(end - start);
+		out.WriteBytes(m_data.data() + start, end - start);
+	}
+}
+
+bool retro3d::Snapshot::ReadDelta(const retro3d::Snapshot &base, const retro3d::Snapshot &delta)
+{
+	retro3d::SnapshotReader in(delta);
+	uint32_t size;
+	if (in.Read(size) == false) { return false; }
+
+	m_data.assign(base.m_data.begin(), base.m_data.begin() + (size < base.GetSize() ? size : base.GetSize()));
+	m_data.resize(size, 0);
+	while (in.IsEnd() == false) {
+		uint32_t start, length;
+		if (in.Read(start) == false || in.Read(length) == false || start > size || length > size - start) {
+			return false;
+		}
+		if (in.ReadBytes(m_data.data() + start, length) == false) {
+			return false;
+		}
+	}
+	return true;
+}
+
+retro3d::SnapshotWriter::SnapshotWriter(retro3d::Snapshot &snapshot) : m_snapshot(snapshot)
+{}
+
+void retro3d::SnapshotWriter::WriteBytes(const void *data, uint32_t size)
+{
+	const uint8_t *bytes = static_cast<const uint8_t*>(data);
+	m_snapshot.GetData().insert(m_snapshot.GetData().end(), bytes, bytes + size);
+}
+
+uint32_t retro3d::SnapshotWriter::GetPosition( void ) const
+{
+	return m_snapshot.GetSize();
+}
+
+void retro3d::SnapshotWriter::Truncate(uint32_t position)
+{
+	m_snapshot.GetData().resize(position);
+}
+
+retro3d::SnapshotReader::SnapshotReader(const retro3d::Snapshot &snapshot) : m_snapshot(snapshot), m_position(0), m_end(snapshot.GetSize()), m_failed(false)
+{}
+
+bool retro3d::SnapshotReader::ReadBytes(void *data, uint32_t size)
+{
+	if (m_failed == true || size > m_end - m_position) {
+		m_failed = true;
+		return false;
+	}
+	std::memcpy(data, m_snapshot.GetData().data() + m_position, size);
+	m_position += size;
+	return true;
+}
+
+bool retro3d::SnapshotReader::Skip(uint32_t size)
+{
+	if (m_failed == true || size > m_end - m_position) {
+		m_failed = true;
+		return false;
+	}
+	m_position += size;
+	return true;
+}
+
+uint32_t retro3d::SnapshotReader::GetPosition( void ) const
+{
+	return m_position;
+}
+
+bool retro3d::SnapshotReader::IsEnd( void ) const
+{
+	return m_position >= m_end;
+}
+
+bool retro3d::SnapshotReader::IsFailed( void ) const
+{
+	return m_failed;
+}
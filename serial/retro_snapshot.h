@@ -0,0 +1,102 @@
+#ifndef RETRO_SNAPSHOT_H
+#define RETRO_SNAPSHOT_H
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace retro3d
+{
+
+// A flat binary image of engine state, used for replays, rollback and quick saves.
+// NOTE: Values are stored in native byte order and layout, so snapshots are only compatible with builds for the same platform.
+class Snapshot
+{
+private:
+	std::vector<uint8_t> m_data;
+
+public:
+	// Removes all data but keeps the memory, so that snapshots taken every frame do not allocate.
+	void Clear( void );
+
+	const std::vector<uint8_t> &GetData( void ) const;
+	std::vector<uint8_t>       &GetData( void );
+	uint32_t                    GetSize( void ) const;
+
+	// Encodes the bytes of this snapshot that differ from 'base' into 'delta'. Small when consecutive snapshots have the same layout, such as between frames.
+	void WriteDelta(const retro3d::Snapshot &base, retro3d::Snapshot &delta) const;
+
+	// Reconstructs this snapshot from 'base' and a delta written by WriteDelta against the same base. Returns false if the delta is malformed.
+	bool ReadDelta(const retro3d::Snapshot &base, const retro3d::Snapshot &delta);
+};
+
+// Appends values to a snapshot.
+class SnapshotWriter
+{
+private:
+	retro3d::Snapshot &m_snapshot;
+
+public:
+	explicit SnapshotWriter(retro3d::Snapshot &snapshot);
+
+	void WriteBytes(const void *data, uint32_t size);
+	template < typename type_t > void Write(const type_t &value);
+
+	// Returns the current write position, which can be used to patch or truncate.
+	uint32_t GetPosition( void ) const;
+
+	// Overwrites a value written earlier, such as a count that is not known up front.
+	template < typename type_t > void Patch(uint32_t position, const type_t &value);
+
+	// Discards everything written after the given position.
+	void Truncate(uint32_t position);
+};
+
+// Reads values from a snapshot in the order they were written. Reading past the end leaves values untouched and fails the reader.
+class SnapshotReader
+{
+private:
+	const retro3d::Snapshot &m_snapshot;
+	uint32_t                 m_position;
+	uint32_t                 m_end;
+	bool                     m_failed;
+
+public:
+	explicit SnapshotReader(const retro3d::Snapshot &snapshot);
+
+	bool ReadBytes(void *data, uint32_t size);
+	template < typename type_t > bool Read(type_t &value);
+
+	// Moves the read position forward without reading.
+	bool Skip(uint32_t size);
+
+	uint32_t GetPosition( void ) const;
+	bool     IsEnd( void ) const;
+	bool     IsFailed( void ) const;
+};
+
+}
+
+template < typename type_t >
+void retro3d::SnapshotWriter::Write(const type_t &value)
+{
+	static_assert(std::is_trivially_copyable<type_t>::value, "Only trivially copyable types can be written as raw bytes");
+	WriteBytes(&value, uint32_t(sizeof(type_t)));
+}
+
+template < typename type_t >
+void retro3d::SnapshotWriter::Patch(uint32_t position, const type_t &value)
+{
+	static_assert(std::is_trivially_copyable<type_t>::value, "Only trivially copyable types can be written as raw bytes");
+	std::memcpy(m_snapshot.GetData().data() + position, &value, sizeof(type_t));
+}
+
+template < typename type_t >
+bool retro3d::SnapshotReader::Read(type_t &value)
+{
+	static_assert(std::is_trivially_copyable<type_t>::value, "Only trivially copyable types can be read as raw bytes");
+	return ReadBytes(&value, uint32_t(sizeof(type_t)));
+}
+
+#endif // RETRO_SNAPSHOT_H